@@ -1,8 +1,34 @@
+#include <cstdlib>
+#include <cstring>
+#include <random>
 #include <iostream>
 #include "header/I2P2_test.h"
 
-int main() {
-  
+int main(int argc, char **argv) {
+  bool seeded = false;
+  unsigned long long seed = 0;
+  bool parallel = false;
+  unsigned workers = 0;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (!std::strcmp(argv[i], "--seed")) {
+      seeded = true;
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (!std::strcmp(argv[i], "-j")) {
+      parallel = true;
+      workers = std::strtoul(argv[++i], nullptr, 10);
+    }
+  }
+
+  if (parallel) {
+    if (!seeded)
+      seed = std::random_device()();
+    const int failed = I2P2_test::fuzz(workers, seed);
+    std::cout << "Finished" << std::endl;
+    return failed ? 1 : 0;
+  }
+  if (seeded)
+    I2P2_test::seed(seed);
+
 #ifdef TEST_LIST
   std::cout << "Checking list ..." << std::endl;
   I2P2_test::check_list();
@@ -13,6 +39,97 @@ int main() {
   I2P2_test::check_vector();
 #endif
 
+#ifdef TEST_COW_VECTOR
+  std::cout << "Checking cow vector ..." << std::endl;
+  I2P2_test::check_cow_vector();
+#endif
+
+#ifdef TEST_PERSISTENT_VECTOR
+  std::cout << "Checking persistent vector ..." << std::endl;
+  I2P2_test::check_persistent_vector();
+#endif
+
+#ifdef TEST_ROPE
+  std::cout << "Checking rope ..." << std::endl;
+  I2P2_test::check_rope();
+#endif
+
+#ifdef TEST_GAP_BUFFER
+  std::cout << "Checking gap buffer ..." << std::endl;
+  I2P2_test::check_gap_buffer();
+#endif
+
+#ifdef TEST_SEGMENTED_VECTOR
+  std::cout << "Checking segmented vector ..." << std::endl;
+  I2P2_test::check_segmented_vector();
+#endif
+
+#ifdef TEST_STATIC_VECTOR
+  std::cout << "Checking static vector ..." << std::endl;
+  I2P2_test::check_static_vector();
+#endif
+#ifdef TEST_FLAT_SET
+  std::cout << "Checking flat set ..." << std::endl;
+  I2P2_test::check_flat_set();
+#endif
+#ifdef TEST_FLAT_MAP
+  std::cout << "Checking flat map ..." << std::endl;
+  I2P2_test::check_flat_map();
+#endif
+#ifdef TEST_EYTZINGER_INDEX
+  std::cout << "Checking eytzinger index ..." << std::endl;
+  I2P2_test::check_eytzinger_index();
+#endif
+#ifdef TEST_HASH_SET
+  std::cout << "Checking hash set ..." << std::endl;
+  I2P2_test::check_hash_set();
+#endif
+#ifdef TEST_HASH_MAP
+  std::cout << "Checking hash map ..." << std::endl;
+  I2P2_test::check_hash_map();
+#endif
+#ifdef TEST_LRU_CACHE
+  std::cout << "Checking lru cache ..." << std::endl;
+  I2P2_test::check_lru_cache();
+#endif
+#ifdef TEST_PRIORITY_QUEUE
+  std::cout << "Checking priority queue ..." << std::endl;
+  I2P2_test::check_priority_queue();
+#endif
+#ifdef TEST_SLOT_MAP
+  std::cout << "Checking slot map ..." << std::endl;
+  I2P2_test::check_slot_map();
+#endif
+#ifdef TEST_PACKED_VECTOR
+  std::cout << "Checking packed vector ..." << std::endl;
+  I2P2_test::check_packed_vector();
+#endif
+#ifdef TEST_SPAN
+  std::cout << "Checking span ..." << std::endl;
+  I2P2_test::check_span();
+#endif
+#ifdef TEST_TRACE
+  std::cout << "Checking trace ..." << std::endl;
+  I2P2_test::check_trace();
+#endif
+#ifdef TEST_STATS
+  std::cout << "Checking stats ..." << std::endl;
+  I2P2_test::check_stats();
+#endif
+#ifdef TEST_LATENCY
+  std::cout << "Checking latency ..." << std::endl;
+  I2P2_test::check_latency();
+#endif
+#ifdef TEST_SPSC_QUEUE
+  std::cout << "Checking spsc queue ..." << std::endl;
+  I2P2_test::check_spsc_queue();
+#endif
+
+#ifdef TEST_CONCURRENT_LIST
+  std::cout << "Checking concurrent list ..." << std::endl;
+  I2P2_test::check_concurrent_list();
+#endif
+
   std::cout << "Finished" << std::endl;
 
   return 0;
@@ -0,0 +1,388 @@
+#include <list>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include "../header/I2P2_def.h"
+#include "../header/I2P2_List.h"
+#include "../header/I2P2_Vector.h"
+#include "../header/I2P2_FlatSet.h"
+#include "../header/I2P2_EytzingerIndex.h"
+#include "../header/I2P2_PriorityQueue.h"
+#include "I2P2_ops.h"
+#include "I2P2_perf.h"
+
+/* Operation-level timings of I2P2 containers next to their std counterparts.
+   Every operation is run on a sweep of sizes and the fastest of `repeat` runs is kept.
+   Output is one CSV row (or JSON object with --json) per container, operation and size, with
+   hardware counters per operation where perf_event_open allows them (empty/null otherwise).
+   --sweep instead traverses Vector and List over growing working sets to show the cache levels,
+   --search times sorted lookups (binary search against EytzingerIndex) over the same sizes, and
+   --heap times priority queues (std heap algorithms against PriorityQueue of several arities). */
+namespace I2P2_bench {
+using bench_clock = std::chrono::steady_clock;
+using I2P2_ops::std_vector;
+using I2P2_ops::std_list;
+
+const char *value_type_name =
+#ifdef INT64
+  "int64";
+#elif DOUBLE
+  "double";
+#else
+  "uint8";
+#endif
+
+const int repeat(5);
+// operations that are O(n) each run this many times per sample instead of n
+const size_t linear_op_cnt(1000);
+
+struct result {
+  const char *container;
+  const char *operation;
+  size_t size;
+  size_t ops;
+  double ns_per_op;
+  double events[I2P2_perf::counter_cnt];  // per op, negative when unavailable
+};
+std::vector<result> results;
+I2P2_perf::counters *perf;
+bool counter_warned[I2P2_perf::counter_cnt];
+
+// names each counter on stderr the first time it has no value, instead of leaving a silent empty column
+void warn_missing(int i) {
+  if (counter_warned[i]) return;
+  counter_warned[i] = true;
+  std::fprintf(stderr, "hardware counter %s unavailable (%s), its column is empty\n", I2P2_perf::counter_names[i],
+               perf->available(static_cast<I2P2_perf::counter>(i)) ? "the kernel never scheduled it"
+                                                                    : "perf_event_open refused it");
+}
+
+std::mt19937_64 mt(2024);
+volatile I2P2::value_type sink;
+volatile size_t position_sink;
+
+I2P2::value_type gen() { return static_cast<I2P2::value_type>(mt() % 255); }
+
+using I2P2_ops::push_front;
+using I2P2_ops::pop_front;
+using I2P2_ops::insert_at;
+using I2P2_ops::erase_at;
+
+template <class C>
+void fill(C &c, size_t n) {
+  for (size_t i(0); i != n; ++i) c.push_back(gen());
+}
+
+// runs setup() untimed and func() timed, repeat times, and records the fastest
+template <class Setup, class Func>
+void measure(const char *container, const char *operation, size_t size, size_t ops, Setup setup, Func func) {
+  result best{container, operation, size, ops, 0, {}};
+  const double div(ops ? ops : 1);
+  for (int r(0); r != repeat; ++r) {
+    setup();
+    perf->start();
+    const auto start(bench_clock::now());
+    func();
+    const double ns(std::chrono::duration<double, std::nano>(bench_clock::now() - start).count());
+    perf->stop();
+    if (r != 0 && ns / div >= best.ns_per_op) continue;
+    best.ns_per_op = ns / div;
+    for (int i(0); i != I2P2_perf::counter_cnt; ++i) {
+      const auto val(perf->value(static_cast<I2P2_perf::counter>(i)));
+      if (val < 0) warn_missing(i);
+      best.events[i] = val < 0 ? -1 : val / div;
+    }
+  }
+  results.push_back(best);
+}
+
+template <class C>
+void bench_ordered(const char *name, size_t n) {
+  C c;
+  const size_t k(std::min(n, linear_op_cnt));
+
+  measure(name, "push_back", n, n, [&c]() { c = C(); }, [&c, n]() { fill(c, n); });
+  measure(name, "pop_back", n, n, [&c, n]() { c = C(); fill(c, n); }, [&c, n]() {
+    for (size_t i(0); i != n; ++i) c.pop_back();
+  });
+  measure(name, "push_front", n, k, [&c, n, k]() { c = C(); fill(c, n - k); }, [&c, k]() {
+    for (size_t i(0); i != k; ++i) push_front(c, gen());
+  });
+  measure(name, "pop_front", n, k, [&c, n]() { c = C(); fill(c, n); }, [&c, k]() {
+    for (size_t i(0); i != k; ++i) pop_front(c);
+  });
+
+  std::vector<size_t> positions(k);
+  measure(name, "insert_random", n, k, [&c, &positions, n, k]() {
+    c = C();
+    fill(c, n - k);
+    for (size_t i(0); i != k; ++i) positions[i] = mt() % (n - k + i + 1);
+  }, [&c, &positions, k]() {
+    for (size_t i(0); i != k; ++i) insert_at(c, positions[i], 1, positions[i]);
+  });
+  measure(name, "erase_random", n, k, [&c, &positions, n, k]() {
+    c = C();
+    fill(c, n);
+    for (size_t i(0); i != k; ++i) positions[i] = mt() % (n - i);
+  }, [&c, &positions, k]() {
+    for (size_t i(0); i != k; ++i) erase_at(c, positions[i]);
+  });
+
+  C src;
+  fill(src, n);
+  measure(name, "copy", n, n, [&c]() { c = C(); }, [&c, &src]() { c = src; });
+  measure(name, "iterate", n, n, []() {}, [&src]() {
+    I2P2::value_type sum(0);
+    for (auto it(src.begin()); it != src.end(); ++it) sum += *it;
+    sink = sum;
+  });
+}
+
+template <class C>
+void bench_randomaccess(const char *name, size_t n) {
+  bench_ordered<C>(name, n);
+
+  C c;
+  measure(name, "index", n, n, [&c, n]() { c = C(); fill(c, n); }, [&c, n]() {
+    I2P2::value_type sum(0);
+    for (size_t i(0); i != n; ++i) sum += c[i];
+    sink = sum;
+  });
+  measure(name, "reserve", n, 1, [&c]() { c = C(); }, [&c, n]() { c.reserve(n); });
+  measure(name, "sort", n, n, [&c, n]() { c = C(); fill(c, n); }, [&c]() { std::sort(c.begin(), c.end()); });
+}
+
+void print_csv() {
+  std::printf("value_type,container,operation,size,ops,ns_per_op");
+  for (int i(0); i != I2P2_perf::counter_cnt; ++i) std::printf(",%s", I2P2_perf::counter_names[i]);
+  std::printf("\n");
+  for (const auto &r : results) {
+    std::printf("%s,%s,%s,%zu,%zu,%.3f", value_type_name, r.container, r.operation, r.size, r.ops, r.ns_per_op);
+    for (int i(0); i != I2P2_perf::counter_cnt; ++i) {
+      if (r.events[i] < 0) std::printf(",");
+      else std::printf(",%.3f", r.events[i]);
+    }
+    std::printf("\n");
+  }
+}
+
+void print_json() {
+  std::printf("[\n");
+  for (size_t i(0); i != results.size(); ++i) {
+    const auto &r(results[i]);
+    std::printf("  {\"value_type\": \"%s\", \"container\": \"%s\", \"operation\": \"%s\", "
+                "\"size\": %zu, \"ops\": %zu, \"ns_per_op\": %.3f",
+                value_type_name, r.container, r.operation, r.size, r.ops, r.ns_per_op);
+    for (int j(0); j != I2P2_perf::counter_cnt; ++j) {
+      if (r.events[j] < 0) std::printf(", \"%s\": null", I2P2_perf::counter_names[j]);
+      else std::printf(", \"%s\": %.3f", I2P2_perf::counter_names[j], r.events[j]);
+    }
+    std::printf("}%s\n", i + 1 == results.size() ? "" : ",");
+  }
+  std::printf("]\n");
+}
+
+/* Working-set sweep: sum every element, over and over, of a Vector and a List of growing size.
+   The List is walked through its nodes directly, so the time is pointer chasing rather than
+   iterator overhead. Nodes are linked in a shuffled order, as they end up in a long-lived list. */
+struct list_walker : I2P2::List {
+  I2P2::value_type sum() const {
+    I2P2::value_type total(0);
+    for (const I2P2::Node *node(head->next); node != tail; node = node->next) total += node->data;
+    return total;
+  }
+  void shuffle_links() {
+    std::vector<I2P2::Node *> nodes;
+    for (I2P2::Node *node(head->next); node != tail; node = node->next) nodes.push_back(node);
+    std::shuffle(nodes.begin(), nodes.end(), mt);
+    I2P2::Node *prev(head);
+    for (auto node : nodes) {
+      prev->next = node;
+      node->prev = prev;
+      prev = node;
+    }
+    prev->next = tail;
+    tail->prev = prev;
+  }
+};
+
+void sweep(size_t max_bytes) {
+  // enough passes that every point touches about the same number of elements
+  const size_t touched(size_t(1) << 26);
+  for (size_t bytes(4096); bytes <= max_bytes; bytes *= 2) {
+    const size_t n_vec(bytes / sizeof(I2P2::value_type));
+    const size_t n_list(bytes / sizeof(I2P2::Node));
+    I2P2::Vector vec;
+    fill(vec, n_vec);
+    list_walker lst;
+    fill(lst, n_list);
+    lst.shuffle_links();
+
+    const size_t vec_passes(std::max<size_t>(1, touched / n_vec));
+    measure("I2P2::Vector", "sweep", bytes, vec_passes * n_vec, []() {}, [&vec, n_vec, vec_passes]() {
+      I2P2::value_type total(0);
+      const I2P2::value_type *data(vec.data());
+      for (size_t p(0); p != vec_passes; ++p)
+        for (size_t i(0); i != n_vec; ++i) total += data[i];
+      sink = total;
+    });
+    const size_t list_passes(std::max<size_t>(1, (touched >> 3) / n_list));
+    measure("I2P2::List", "sweep", bytes, list_passes * n_list, []() {}, [&lst, list_passes]() {
+      I2P2::value_type total(0);
+      for (size_t p(0); p != list_passes; ++p) total += lst.sum();
+      sink = total;
+    });
+  }
+}
+
+/* Lookup sweep: random lower_bound queries into sorted data of growing size, by plain binary search
+   over the Vector (std::lower_bound and the branchless flat_lower_bound) and through an
+   EytzingerIndex, one query at a time and batched. */
+void search(size_t max_bytes) {
+  const size_t query_cnt(1 << 20);
+  for (size_t bytes(4096); bytes <= max_bytes; bytes *= 2) {
+    const size_t n(bytes / sizeof(I2P2::value_type));
+    I2P2::Vector sorted;
+    for (size_t i(0); i != n; ++i) sorted.push_back(static_cast<I2P2::value_type>(2 * i));
+    std::sort(sorted.data(), sorted.data() + n);
+    const I2P2::EytzingerIndex index(sorted);
+    std::vector<I2P2::value_type> keys(query_cnt);
+    for (auto &key : keys) key = static_cast<I2P2::value_type>(mt() % (2 * n));
+    std::vector<size_t> out(query_cnt);
+    const I2P2::value_type *data(sorted.data());
+
+    measure("std::lower_bound", "lower_bound", bytes, query_cnt, []() {}, [&keys, data, n]() {
+      size_t total(0);
+      for (auto key : keys) total += std::lower_bound(data, data + n, key) - data;
+      position_sink = total;
+    });
+    measure("flat_lower_bound", "lower_bound", bytes, query_cnt, []() {}, [&keys, data, n]() {
+      size_t total(0);
+      for (auto key : keys) total += I2P2::flat_lower_bound(data, n, key);
+      position_sink = total;
+    });
+    measure("I2P2::EytzingerIndex", "lower_bound", bytes, query_cnt, []() {}, [&keys, &index]() {
+      size_t total(0);
+      for (auto key : keys) total += index.lower_bound(key);
+      position_sink = total;
+    });
+    measure("I2P2::EytzingerIndex", "lower_bound_many", bytes, query_cnt, []() {}, [&keys, &index, &out]() {
+      index.lower_bound_many(I2P2::VectorView(keys.data(), keys.size()), out.data());
+      position_sink = out.back();
+    });
+  }
+}
+/* Heap sweep: n pushes of random values then n pops, with std::push_heap/pop_heap over a Vector's
+   iterators and over its raw elements, and with PriorityQueue at arity 2, 4 and 8; then an O(n)
+   bulk build with std::make_heap and PriorityQueue::heapify. */
+void heap(size_t max_bytes) {
+  for (size_t bytes(4096); bytes <= max_bytes; bytes *= 2) {
+    const size_t n(bytes / sizeof(I2P2::value_type));
+    std::vector<I2P2::value_type> values(n);
+    for (auto &val : values) val = static_cast<I2P2::value_type>(mt());
+    I2P2::Vector vec;
+
+    measure("std::push_heap(iterator)", "push_pop", bytes, 2 * n, [&vec]() { vec.clear(); }, [&vec, &values]() {
+      for (auto val : values) {
+        vec.push_back(val);
+        std::push_heap(vec.begin(), vec.end());
+      }
+      I2P2::value_type total(0);
+      while (!vec.empty()) {
+        total += vec.front();
+        std::pop_heap(vec.begin(), vec.end());
+        vec.pop_back();
+      }
+      sink = total;
+    });
+    measure("std::push_heap(pointer)", "push_pop", bytes, 2 * n, [&vec]() { vec.clear(); }, [&vec, &values]() {
+      for (auto val : values) {
+        vec.push_back(val);
+        std::push_heap(vec.data(), vec.data() + vec.size());
+      }
+      I2P2::value_type total(0);
+      while (!vec.empty()) {
+        total += vec.front();
+        std::pop_heap(vec.data(), vec.data() + vec.size());
+        vec.pop_back();
+      }
+      sink = total;
+    });
+    const char *const names[] = {"I2P2::PriorityQueue(2)", "I2P2::PriorityQueue(4)", "I2P2::PriorityQueue(8)"};
+    for (size_t arity(2), i(0); arity <= 8; arity *= 2, ++i) {
+      I2P2::PriorityQueue queue(arity);
+      queue.reserve(n);
+      measure(names[i], "push_pop", bytes, 2 * n, [&queue]() { queue.clear(); }, [&queue, &values]() {
+        for (auto val : values) queue.push(val);
+        I2P2::value_type total(0);
+        while (!queue.empty()) {
+          total += queue.top();
+          queue.pop();
+        }
+        sink = total;
+      });
+    }
+
+    measure("std::make_heap(pointer)", "heapify", bytes, n, [&vec, &values]() {
+      vec.clear();
+      vec.append(values.data(), values.size());
+    }, [&vec]() { std::make_heap(vec.data(), vec.data() + vec.size()); });
+    I2P2::PriorityQueue queue;
+    measure("I2P2::PriorityQueue(4)", "heapify", bytes, n, [&vec, &values]() {
+      vec.clear();
+      vec.append(values.data(), values.size());
+    }, [&vec, &queue]() { queue.heapify(vec); });
+  }
+}
+}  // namespace I2P2_bench
+
+int main(int argc, char **argv) {
+  bool json(false), sweep(false), search(false), heap(false);
+  size_t max_size(1 << 16), sweep_max(size_t(1) << 27);
+  for (int i(1); i != argc; ++i) {
+    if (!std::strcmp(argv[i], "--json")) json = true;
+    else if (!std::strcmp(argv[i], "--max") && i + 1 != argc) max_size = std::strtoull(argv[++i], nullptr, 10);
+    else if (!std::strcmp(argv[i], "--sweep")) sweep = true;
+    else if (!std::strcmp(argv[i], "--search")) search = true;
+    else if (!std::strcmp(argv[i], "--heap")) heap = true;
+    else if (!std::strcmp(argv[i], "--sweep-max") && i + 1 != argc) sweep_max = std::strtoull(argv[++i], nullptr, 10);
+    else {
+      std::fprintf(stderr, "usage: %s [--json] [--max SIZE] [--sweep] [--search] [--heap] [--sweep-max BYTES]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  I2P2_perf::counters perf;
+  I2P2_bench::perf = &perf;
+  if (!perf.available()) {
+    std::fprintf(stderr, "hardware counters unavailable (perf_event_open failed), reporting time only\n");
+    std::fill(I2P2_bench::counter_warned, I2P2_bench::counter_warned + I2P2_perf::counter_cnt, true);
+  } else {
+    for (int i(0); i != I2P2_perf::counter_cnt; ++i)
+      if (!perf.available(static_cast<I2P2_perf::counter>(i))) I2P2_bench::warn_missing(i);
+  }
+
+  if (sweep) {
+    I2P2_bench::sweep(sweep_max);
+  } else if (search) {
+    I2P2_bench::search(sweep_max);
+  } else if (heap) {
+    I2P2_bench::heap(sweep_max);
+  } else {
+    for (size_t n(16); n <= max_size; n *= 4) {
+      I2P2_bench::bench_randomaccess<I2P2::Vector>("I2P2::Vector", n);
+      I2P2_bench::bench_randomaccess<I2P2_bench::std_vector>("std::vector", n);
+      I2P2_bench::bench_ordered<I2P2::List>("I2P2::List", n);
+      I2P2_bench::bench_ordered<I2P2_bench::std_list>("std::list", n);
+    }
+  }
+
+  if (json) I2P2_bench::print_json();
+  else I2P2_bench::print_csv();
+}
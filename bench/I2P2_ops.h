@@ -0,0 +1,41 @@
+#ifndef I2P2_OPS_H
+#define I2P2_OPS_H
+#include <list>
+#include <vector>
+#include <iterator>
+#include "../header/I2P2_def.h"
+
+/* The I2P2 and std containers disagree on how to say a few things; these overloads paper over it
+   so the benchmark and the replayer can drive all of them from one template. */
+namespace I2P2_ops {
+using std_vector = std::vector<I2P2::value_type>;
+using std_list = std::list<I2P2::value_type>;
+
+template <class C>
+void push_front(C &c, I2P2::value_type val) { c.push_front(val); }
+inline void push_front(std_vector &c, I2P2::value_type val) { c.insert(c.begin(), val); }
+
+template <class C>
+void pop_front(C &c) { c.pop_front(); }
+inline void pop_front(std_vector &c) { c.erase(c.begin()); }
+
+template <class C>
+auto at(C &c, size_t pos) -> decltype(c.begin() + pos) { return c.begin() + pos; }
+inline std_list::iterator at(std_list &c, size_t pos) { return std::next(c.begin(), pos); }
+
+template <class C>
+void insert_at(C &c, size_t pos, size_t count, I2P2::value_type val) { c.insert(at(c, pos), count, val); }
+
+template <class C>
+void erase_at(C &c, size_t pos) { c.erase(at(c, pos)); }
+
+template <class C>
+void erase_range_at(C &c, size_t pos, size_t count) {
+  auto begin(at(c, pos));
+  auto end(begin);
+  std::advance(end, count);
+  c.erase(begin, end);
+}
+}  // namespace I2P2_ops
+
+#endif
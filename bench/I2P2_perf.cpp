@@ -0,0 +1,99 @@
+#include "I2P2_perf.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace I2P2_perf {
+const char *const counter_names[counter_cnt] = {
+  "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+};
+
+#ifdef __linux__
+namespace {
+  const unsigned long long cache_read_miss =
+    (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+  int open_event(unsigned type, unsigned long long config)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+}
+
+counters::counters()
+{
+  fds[cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  fds[instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  fds[l1d_misses] = open_event(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cache_read_miss);
+  fds[llc_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  fds[branch_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+  fds[dtlb_misses] = open_event(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | cache_read_miss);
+  for (int i = 0; i < counter_cnt; i++)
+    values[i] = -1;
+}
+counters::~counters()
+{
+  for (int i = 0; i < counter_cnt; i++)
+    if (fds[i] >= 0)
+      close(fds[i]);
+}
+bool counters::available() const
+{
+  for (int i = 0; i < counter_cnt; i++)
+    if (fds[i] >= 0)
+      return true;
+  return false;
+}
+void counters::start()
+{
+  for (int i = 0; i < counter_cnt; i++)
+    if (fds[i] >= 0)
+    {
+      ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+void counters::stop()
+{
+  for (int i = 0; i < counter_cnt; i++)
+    if (fds[i] >= 0)
+      ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+  for (int i = 0; i < counter_cnt; i++)
+  {
+    // value, time enabled, time running
+    unsigned long long buf[3];
+    values[i] = -1;
+    if (fds[i] < 0 || read(fds[i], buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0)
+      continue;
+    values[i] = buf[2] < buf[1] ? static_cast<long long>(static_cast<double>(buf[0]) * buf[1] / buf[2]) : buf[0];
+  }
+}
+#else
+counters::counters()
+{
+  for (int i = 0; i < counter_cnt; i++)
+  {
+    fds[i] = -1;
+    values[i] = -1;
+  }
+}
+counters::~counters() {}
+bool counters::available() const { return false; }
+void counters::start() {}
+void counters::stop() {}
+#endif
+}  // namespace I2P2_perf
@@ -0,0 +1,41 @@
+#ifndef I2P2_PERF_H
+#define I2P2_PERF_H
+
+/* Hardware counters around a region of code, read through perf_event_open(2).
+   Each event is opened on its own so one the CPU or kernel refuses does not take the others
+   down; a missing event reads as -1. Counts are user-space only and scaled when the kernel
+   had to multiplex. Off Linux, or when perf_event_paranoid forbids it, nothing is available. */
+namespace I2P2_perf {
+enum counter {
+  cycles,
+  instructions,
+  l1d_misses,
+  llc_misses,
+  branch_misses,
+  dtlb_misses,
+  counter_cnt
+};
+extern const char *const counter_names[counter_cnt];
+
+class counters {
+ private:
+  int fds[counter_cnt];
+  long long values[counter_cnt];
+
+ public:
+  counters();
+  ~counters();
+  counters(const counters &rhs) = delete;
+  counters &operator=(const counters &rhs) = delete;
+  // whether any event could be opened
+  bool available() const;
+  // whether this event could be opened
+  bool available(counter c) const { return fds[c] >= 0; }
+  void start();
+  void stop();
+  // count of the last start()/stop() window, -1 if the event is unavailable
+  long long value(counter c) const { return values[c]; }
+};
+}  // namespace I2P2_perf
+
+#endif
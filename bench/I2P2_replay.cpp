@@ -0,0 +1,209 @@
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include "../header/I2P2_def.h"
+#include "../header/I2P2_List.h"
+#include "../header/I2P2_Vector.h"
+#include "../header/I2P2_trace.h"
+#include "I2P2_ops.h"
+
+/* Plays an operation trace (header/I2P2_trace.h) against I2P2::Vector, I2P2::List, std::vector and
+   std::list, and reports the total time and the latency of each kind of operation.
+     replay generate OUT [--seed S] [--ops N]   write a random trace
+     replay run TRACE [--json]                  time a trace */
+namespace I2P2_replay {
+using replay_clock = std::chrono::steady_clock;
+
+struct op_stats {
+  size_t count;
+  double total_ns;
+  double max_ns;
+};
+
+struct report {
+  const char *container;
+  double total_ns;
+  size_t skipped;
+  op_stats ops[I2P2::trace_op_cnt];
+};
+std::vector<report> reports;
+
+volatile I2P2::value_type sink;
+
+// applies one record, false if it does not fit the container's current size
+template <class C>
+bool apply(C &c, const I2P2::trace_record &rec) {
+  using namespace I2P2_ops;
+  const size_t size(c.size());
+  switch (rec.op) {
+    case I2P2::trace_push_back:
+      c.push_back(rec.val);
+      return true;
+    case I2P2::trace_push_front:
+      push_front(c, rec.val);
+      return true;
+    case I2P2::trace_pop_back:
+      if (size == 0) return false;
+      c.pop_back();
+      return true;
+    case I2P2::trace_pop_front:
+      if (size == 0) return false;
+      pop_front(c);
+      return true;
+    case I2P2::trace_insert:
+      if (rec.pos > size) return false;
+      insert_at(c, rec.pos, rec.count, rec.val);
+      return true;
+    case I2P2::trace_erase:
+      if (rec.pos >= size) return false;
+      erase_at(c, rec.pos);
+      return true;
+    case I2P2::trace_erase_range:
+      if (rec.pos > size || rec.count > size - rec.pos) return false;
+      erase_range_at(c, rec.pos, rec.count);
+      return true;
+    case I2P2::trace_clear:
+      c.clear();
+      return true;
+    case I2P2::trace_read:
+      if (rec.pos >= size) return false;
+      sink = *at(c, rec.pos);
+      return true;
+    case I2P2::trace_write:
+      if (rec.pos >= size) return false;
+      *at(c, rec.pos) = rec.val;
+      return true;
+    case I2P2::trace_iterate: {
+      I2P2::value_type sum(0);
+      for (auto it(c.begin()); it != c.end(); ++it) sum += *it;
+      sink = sum;
+      return true;
+    }
+    case I2P2::trace_copy: {
+      C copy(c);
+      sink = copy.size();
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+template <class C>
+void replay(const char *name, const std::vector<I2P2::trace_record> &trace) {
+  report rep;
+  std::memset(&rep, 0, sizeof(rep));
+  rep.container = name;
+
+  C c;
+  const auto begin(replay_clock::now());
+  for (const auto &rec : trace) {
+    const auto start(replay_clock::now());
+    const bool applied(apply(c, rec));
+    const double ns(std::chrono::duration<double, std::nano>(replay_clock::now() - start).count());
+    if (!applied) {
+      rep.skipped++;
+      continue;
+    }
+    op_stats &stats(rep.ops[rec.op]);
+    stats.count++;
+    stats.total_ns += ns;
+    stats.max_ns = std::max(stats.max_ns, ns);
+  }
+  rep.total_ns = std::chrono::duration<double, std::nano>(replay_clock::now() - begin).count();
+  reports.push_back(rep);
+}
+
+void print_csv() {
+  std::printf("container,operation,count,total_ns,mean_ns,max_ns\n");
+  for (const auto &rep : reports) {
+    // count keeps one meaning in every row: operations in the total row, and the skipped ones get a row of their own
+    size_t applied(0);
+    for (int i(0); i != I2P2::trace_op_cnt; ++i) applied += rep.ops[i].count;
+    std::printf("%s,total,%zu,%.0f,,\n", rep.container, applied, rep.total_ns);
+    std::printf("%s,skipped,%zu,,,\n", rep.container, rep.skipped);
+    for (int i(0); i != I2P2::trace_op_cnt; ++i) {
+      const op_stats &s(rep.ops[i]);
+      if (s.count == 0) continue;
+      std::printf("%s,%s,%zu,%.0f,%.1f,%.0f\n", rep.container, I2P2::trace_op_names[i], s.count, s.total_ns,
+                  s.total_ns / s.count, s.max_ns);
+    }
+  }
+}
+
+void print_json() {
+  std::printf("[\n");
+  for (size_t r(0); r != reports.size(); ++r) {
+    const auto &rep(reports[r]);
+    std::printf("  {\"container\": \"%s\", \"total_ns\": %.0f, \"skipped\": %zu, \"operations\": {",
+                rep.container, rep.total_ns, rep.skipped);
+    bool first(true);
+    for (int i(0); i != I2P2::trace_op_cnt; ++i) {
+      const op_stats &s(rep.ops[i]);
+      if (s.count == 0) continue;
+      std::printf("%s\"%s\": {\"count\": %zu, \"total_ns\": %.0f, \"mean_ns\": %.1f, \"max_ns\": %.0f}",
+                  first ? "" : ", ", I2P2::trace_op_names[i], s.count, s.total_ns, s.total_ns / s.count, s.max_ns);
+      first = false;
+    }
+    std::printf("}}%s\n", r + 1 == reports.size() ? "" : ",");
+  }
+  std::printf("]\n");
+}
+
+int usage(const char *prog) {
+  std::fprintf(stderr, "usage: %s generate OUT [--seed S] [--ops N]\n       %s run TRACE [--json]\n", prog, prog);
+  return 1;
+}
+}  // namespace I2P2_replay
+
+int main(int argc, char **argv) {
+  if (argc < 3) return I2P2_replay::usage(argv[0]);
+
+  if (!std::strcmp(argv[1], "generate")) {
+    unsigned long long seed(1), ops(1 << 20);
+    for (int i(3); i != argc; ++i) {
+      if (!std::strcmp(argv[i], "--seed") && i + 1 != argc) seed = std::strtoull(argv[++i], nullptr, 10);
+      else if (!std::strcmp(argv[i], "--ops") && i + 1 != argc) ops = std::strtoull(argv[++i], nullptr, 10);
+      else return I2P2_replay::usage(argv[0]);
+    }
+    I2P2::trace_writer out(argv[2]);
+    if (!out.ok()) {
+      std::fprintf(stderr, "cannot write %s\n", argv[2]);
+      return 1;
+    }
+    I2P2::generate_trace(out, seed, ops);
+    if (!out.flush()) {
+      std::fprintf(stderr, "writing %s failed, the trace is incomplete\n", argv[2]);
+      return 1;
+    }
+    return 0;
+  }
+
+  if (std::strcmp(argv[1], "run")) return I2P2_replay::usage(argv[0]);
+  bool json(false);
+  for (int i(3); i != argc; ++i) {
+    if (!std::strcmp(argv[i], "--json")) json = true;
+    else return I2P2_replay::usage(argv[0]);
+  }
+
+  I2P2::trace_reader in(argv[2]);
+  if (!in.ok()) {
+    std::fprintf(stderr, "cannot read %s, or it was recorded with another value_type\n", argv[2]);
+    return 1;
+  }
+  std::vector<I2P2::trace_record> trace;
+  I2P2::trace_record rec;
+  while (in.next(rec)) trace.push_back(rec);
+
+  I2P2_replay::replay<I2P2::Vector>("I2P2::Vector", trace);
+  I2P2_replay::replay<I2P2_ops::std_vector>("std::vector", trace);
+  I2P2_replay::replay<I2P2::List>("I2P2::List", trace);
+  I2P2_replay::replay<I2P2_ops::std_list>("std::list", trace);
+
+  if (json) I2P2_replay::print_json();
+  else I2P2_replay::print_csv();
+}
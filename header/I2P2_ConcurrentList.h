@@ -0,0 +1,123 @@
+#ifndef I2P2_CONCURRENTLIST_H
+#define I2P2_CONCURRENTLIST_H
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "I2P2_container.h"
+
+namespace I2P2
+{
+  struct ConcurrentNode
+  {
+    std::mutex lock;
+    std::atomic<ConcurrentNode*> prev, next;
+    std::atomic<bool> marked;
+    ConcurrentNode* retired_next;
+    value_type data;
+    ConcurrentNode(value_type d = 0) : prev(nullptr), next(nullptr), marked(false), retired_next(nullptr), data(d) {}
+  };
+
+  // one pin's announcement to the list: the epoch it entered in, or 0 while the slot is not pinned
+  struct EpochSlot
+  {
+    std::atomic<uint64_t> epoch;
+    std::atomic<bool> claimed;
+    EpochSlot* next;
+    EpochSlot() : epoch(0), claimed(true), next(nullptr) {}
+  };
+
+  /* Doubly-linked list that allows many threads to insert and erase at different positions at once.
+     Every mutation locks only the nodes it relinks (left to right, so it cannot deadlock) and
+     re-validates them under the locks. Erased nodes are marked and keep their links, so a reader
+     standing on an erased node can keep walking. They are freed by epoch-based reclamation: every
+     pin announces the global epoch it entered in, the epoch advances once every live pin has seen
+     the current one, and a node retired in epoch e is freed when the epoch reaches e + 2, by which
+     time every pin that could have reached it has ended. Overlapping short pins therefore never
+     hold memory back; only a single pin kept alive stalls reclamation. */
+  class ConcurrentList : public container_base
+  {
+    public:
+      typedef ConcurrentNode* handle;
+
+      /* While a pin is alive, no node it can reach is freed. Every public method pins internally;
+         hold one yourself to keep handles across several calls. */
+      class pin
+      {
+        private:
+          const ConcurrentList* _list;
+          EpochSlot* _slot;
+        public:
+          explicit pin(const ConcurrentList &list);
+          pin(const pin &rhs) = delete;
+          pin &operator=(const pin &rhs) = delete;
+          ~pin();
+      };
+
+      /* Forward cursor that tolerates concurrent modification: erased nodes are skipped and
+         elements inserted ahead of it may or may not be visited. */
+      class cursor
+      {
+        private:
+          pin _pin;
+          const ConcurrentList* _list;
+          handle _node;
+          void skip_marked();
+        public:
+          explicit cursor(const ConcurrentList &list);
+          bool valid() const;
+          void advance();
+          value_type value() const;
+          handle get() const;
+      };
+
+    private:
+      handle head;
+      handle tail;
+      std::atomic<size_type> _size;
+      mutable std::atomic<uint64_t> epoch;
+      mutable std::atomic<EpochSlot*> slots;
+      mutable std::mutex retired_lock;
+      // erased nodes awaiting reclamation, by the epoch they were retired in modulo 3
+      mutable handle retired[3];
+      mutable uint64_t retired_epoch[3];
+      mutable std::atomic<size_type> retired_cnt;
+
+      EpochSlot* enter() const;
+      void leave(EpochSlot* slot) const;
+      void retire(handle node);
+      void try_advance() const;
+      void reclaim() const;
+      handle link_after(handle pos, const_reference val);
+      handle link_before(handle pos, const_reference val);
+      bool unlink(handle node);
+
+    public:
+      ~ConcurrentList();
+      ConcurrentList();
+      ConcurrentList(const ConcurrentList &rhs) = delete;
+      ConcurrentList &operator=(const ConcurrentList &rhs) = delete;
+      size_type size() const;
+      bool empty() const;
+      // erased nodes not yet freed
+      size_type retired_count() const;
+      handle push_back(const_reference val);
+      handle push_front(const_reference val);
+      handle insert_after(handle pos, const_reference val);
+      handle insert_before(handle pos, const_reference val);
+      bool erase(handle pos);
+      bool pop_back(reference val);
+      bool pop_front(reference val);
+      void clear();
+      template <class Func>
+      void for_each(Func func) const;
+  };
+
+  template <class Func>
+  void ConcurrentList::for_each(Func func) const
+  {
+    for (cursor it(*this); it.valid(); it.advance())
+      func(it.value());
+  }
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef I2P2_COWVECTOR_H
+#define I2P2_COWVECTOR_H
+#include <atomic>
+#include "I2P2_container.h"
+#include "I2P2_iterator.h"
+#include "I2P2_Vector.h"
+
+namespace I2P2
+{
+  /* Vector whose copies share one reference-counted buffer until the first mutation.
+     Handing out a mutable reference or iterator marks the buffer unshareable, so later copies
+     deep-copy instead of aliasing it; the mark is dropped once the buffer is reallocated or cleared. */
+  class CowVector : public randomaccess_container
+  {
+    private:
+      struct rep
+      {
+        std::atomic<size_type> refs;
+        bool shareable;
+        Vector vec;
+        rep() : refs(1), shareable(true) {}
+        rep(const Vector &v) : refs(1), shareable(true), vec(v) {}
+      };
+      rep* _rep;
+
+      void release();
+      void detach();
+      rep* share() const;
+      const_pointer data_ref() const;
+
+    public:
+      ~CowVector();
+      CowVector();
+      CowVector(const CowVector &rhs);
+      CowVector &operator=(const CowVector &rhs);
+      bool shared() const;
+
+  /* The following are standard methods from the STL */
+    public:
+      iterator begin();
+      const_iterator begin() const;
+      iterator end();
+      const_iterator end() const;
+      reference front();
+      const_reference front() const;
+      reference back();
+      const_reference back() const;
+      reference operator[](size_type pos);
+      const_reference operator[](size_type pos) const;
+      size_type capacity() const;
+      size_type size() const;
+      void clear();
+      bool empty() const;
+      void erase(const_iterator pos);
+      void erase(const_iterator begin, const_iterator end);
+      void insert(const_iterator pos, size_type count, const_reference val);
+      void insert(const_iterator pos, const_iterator begin, const_iterator end);
+      void pop_back();
+      void pop_front();
+      void push_back(const_reference val);
+      void push_front(const_reference val);
+      void reserve(size_type new_capacity);
+      void shrink_to_fit();
+  };
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef I2P2_EYTZINGERINDEX_H
+#define I2P2_EYTZINGERINDEX_H
+#include <vector>
+#include "I2P2_def.h"
+#include "I2P2_Vector.h"
+#include "I2P2_Span.h"
+
+namespace I2P2
+{
+  /* Read-only search index over a sorted Vector, stored in Eytzinger (BFS) order: the root at 1 and
+     the children of k at 2k and 2k + 1. The top levels of every search share the same few cache
+     lines, and the 2^d descendants of k that are d levels down are contiguous, so the search
+     prefetches the line holding them while it is still comparing d levels above. Results are
+     positions in the sorted input, so they can index data kept alongside it.
+     The index is a copy: it does not follow later changes to the Vector. */
+  class EytzingerIndex
+  {
+    private:
+      Vector _tree;                    // _tree[0] is padding
+      std::vector<size_type> _rank;    // position in the sorted input of each tree slot
+      size_type _size;
+      int _depth;                      // number of complete levels
+
+      size_type fill(VectorView sorted, size_type i, size_type k);
+      // the slot of the first element not less than key, 0 if there is none
+      size_type search(value_type key) const;
+
+    public:
+      EytzingerIndex();
+      // sorted must be in non-decreasing order
+      explicit EytzingerIndex(VectorView sorted);
+      void build(VectorView sorted);
+
+      size_type size() const { return _size; }
+      bool empty() const { return _size == 0; }
+      // like std::lower_bound on the sorted input: position of the first element not less than key, or size()
+      size_type lower_bound(value_type key) const;
+      // position of an element equal to key, or size()
+      size_type find(value_type key) const;
+      /* lower_bound for every key, written to out. Queries go in groups that advance one level in
+         lockstep, so the cache misses of a group overlap instead of queueing up behind each other. */
+      void lower_bound_many(VectorView keys, size_type *out) const;
+  };
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef I2P2_FLATMAP_H
+#define I2P2_FLATMAP_H
+#include "I2P2_container.h"
+#include "I2P2_Vector.h"
+#include "I2P2_Span.h"
+#include "I2P2_FlatSet.h"
+
+namespace I2P2
+{
+  /* Sorted map from value_type to value_type, kept as two parallel Vectors. Searches touch only the
+     dense key array; the value at the same index is read once the key is found. */
+  class FlatMap : public container_base
+  {
+    private:
+      Vector _keys;
+      Vector _values;
+
+    public:
+      FlatMap();
+
+      const Vector &keys() const { return _keys; }
+      const Vector &values() const { return _values; }
+      const_reference key_at(size_type pos) const { return _keys[pos]; }
+      reference value_at(size_type pos) { return _values[pos]; }
+      const_reference value_at(size_type pos) const { return _values[pos]; }
+
+      size_type lower_bound(const_reference key) const { return flat_lower_bound(_keys.data(), _keys.size(), key); }
+      // index of key, or size() when absent
+      size_type find(const_reference key) const;
+      bool contains(const_reference key) const { return find(key) != size(); }
+      // throws std::out_of_range when key is absent
+      reference at(const_reference key);
+      const_reference at(const_reference key) const;
+      // inserts key with a value-initialized value when absent
+      reference operator[](const_reference key);
+
+      // false, leaving the old value, if key was already present
+      bool insert(const_reference key, const_reference val);
+      // true if key was new
+      bool insert_or_assign(const_reference key, const_reference val);
+      /* Sorts the batch by key and merges it in one pass. As with insert, present keys keep their value,
+         and of equal keys in the batch the first wins. Returns how many keys were new. */
+      size_type insert_many(VectorView keys, VectorView values);
+      bool erase(const_reference key);
+      // removes every pair pred(key, value) holds for in one compaction pass; returns how many
+      template <class Pred>
+      size_type erase_if(Pred pred)
+      {
+        pointer keys = _keys.data();
+        pointer values = _values.data();
+        size_type n = _keys.size();
+        size_type kept = 0;
+        for (size_type i = 0; i < n; i++)
+        {
+          if (pred(keys[i], values[i]))
+            continue;
+          keys[kept] = keys[i];
+          values[kept] = values[i];
+          kept++;
+        }
+        _keys.resize(kept);
+        _values.resize(kept);
+        return n - kept;
+      }
+
+      void reserve(size_type new_capacity);
+      void clear();
+      size_type size() const { return _keys.size(); }
+      bool empty() const { return _keys.empty(); }
+  };
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef I2P2_FLATSET_H
+#define I2P2_FLATSET_H
+#include <algorithm>
+#include "I2P2_container.h"
+#include "I2P2_Vector.h"
+#include "I2P2_Span.h"
+
+namespace I2P2
+{
+  /* Index of the first element of the sorted range [first, first + count) that is not less than key.
+     The loop has a fixed trip count and no data-dependent branch: the comparison only selects the
+     next base, which compiles to a conditional move. */
+  inline size_type flat_lower_bound(const_pointer first, size_type count, value_type key)
+  {
+    if (count == 0)
+      return 0;
+
+    const_pointer base = first;
+    while (count > 1)
+    {
+      size_type half = count / 2;
+      base = base[half] < key ? base + half : base;
+      count -= half;
+    }
+    return (base - first) + (*base < key);
+  }
+
+  /* A sorted, duplicate-free Vector. Lookups are branchless binary searches, insert_many merges a
+     whole batch in one pass, and erase_if compacts in place. Iterators reach the elements in order;
+     writing through them must not change the order. */
+  class FlatSet : public dynamic_size_container
+  {
+    private:
+      Vector _keys;
+
+    public:
+      FlatSet();
+      // sorts and dedups src
+      explicit FlatSet(VectorView src);
+
+      const Vector &keys() const { return _keys; }
+      const_pointer data() const { return _keys.data(); }
+      const_reference operator[](size_type pos) const { return _keys[pos]; }
+
+      size_type lower_bound(const_reference key) const { return flat_lower_bound(_keys.data(), _keys.size(), key); }
+      size_type upper_bound(const_reference key) const;
+      // index of key, or size() when absent
+      size_type find(const_reference key) const;
+      bool contains(const_reference key) const { return find(key) != size(); }
+      size_type count(const_reference key) const { return contains(key); }
+
+      // false if key was already present; O(n) for the shift, use insert_many for batches
+      bool insert(const_reference key);
+      // sorts the batch, then merges it in one O(n + k) pass from the back; returns how many were new
+      size_type insert_many(VectorView batch);
+      size_type insert_many(const_pointer batch, size_type count) { return insert_many(VectorView(batch, count)); }
+      // false if key was absent
+      bool erase(const_reference key);
+      // removes every element pred(element) holds for in one compaction pass; returns how many
+      template <class Pred>
+      size_type erase_if(Pred pred)
+      {
+        pointer first = _keys.data();
+        pointer last = first + _keys.size();
+        size_type removed = last - std::remove_if(first, last, pred);
+        _keys.resize(_keys.size() - removed);
+        return removed;
+      }
+
+  /* The following are standard methods from the STL */
+    public:
+      iterator begin() final { return _keys.begin(); }
+      const_iterator begin() const final { return _keys.begin(); }
+      iterator end() final { return _keys.end(); }
+      const_iterator end() const final { return _keys.end(); }
+      size_type capacity() const final { return _keys.capacity(); }
+      size_type size() const final { return _keys.size(); }
+      bool empty() const final { return _keys.empty(); }
+      void clear() final { _keys.clear(); }
+      void erase(const_iterator pos) final { _keys.erase(pos); }
+      void erase(const_iterator begin, const_iterator end) final { _keys.erase(begin, end); }
+      void reserve(size_type new_capacity) final { _keys.reserve(new_capacity); }
+      void shrink_to_fit() final { _keys.shrink_to_fit(); }
+  };
+}  // namespace I2P2
+
+#endif
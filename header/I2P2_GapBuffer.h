@@ -0,0 +1,65 @@
+#ifndef I2P2_GAPBUFFER_H
+#define I2P2_GAPBUFFER_H
+#include "I2P2_container.h"
+#include "I2P2_iterator.h"
+
+namespace I2P2
+{
+  /* One allocation laid out as [front elements | gap | back elements]. The gap sits at the cursor,
+     so inserting or erasing there is O(1); moving the cursor shifts only the elements it passes. */
+  class GapBuffer : public randomaccess_container
+  {
+    private:
+      pointer p_begin;
+      pointer p_gap;
+      pointer p_gap_end;
+      pointer p_end;
+
+      void move_gap(size_type pos);
+      void reallocate(size_type new_capacity);
+      void make_room(size_type count);
+
+    public:
+      ~GapBuffer();
+      GapBuffer();
+      GapBuffer(const GapBuffer &rhs);
+      GapBuffer &operator=(const GapBuffer &rhs);
+
+    /* Cursor editing */
+      size_type cursor() const;
+      void move_cursor(size_type pos);
+      void insert_at_cursor(const_reference val);
+      void erase_before_cursor();
+      void erase_after_cursor();
+      pointer data();
+
+  /* The following are standard methods from the STL */
+    public:
+      iterator begin();
+      const_iterator begin() const;
+      iterator end();
+      const_iterator end() const;
+      reference front();
+      const_reference front() const;
+      reference back();
+      const_reference back() const;
+      reference operator[](size_type pos);
+      const_reference operator[](size_type pos) const;
+      size_type capacity() const;
+      size_type size() const;
+      void clear();
+      bool empty() const;
+      void erase(const_iterator pos);
+      void erase(const_iterator begin, const_iterator end);
+      void insert(const_iterator pos, size_type count, const_reference val);
+      void insert(const_iterator pos, const_iterator begin, const_iterator end);
+      void pop_back();
+      void pop_front();
+      void push_back(const_reference val);
+      void push_front(const_reference val);
+      void reserve(size_type new_capacity);
+      void shrink_to_fit();
+  };
+}  // namespace I2P2
+
+#endif
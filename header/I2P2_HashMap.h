@@ -0,0 +1,94 @@
+#ifndef I2P2_HASHMAP_H
+#define I2P2_HASHMAP_H
+#include <stdexcept>
+#include "I2P2_container.h"
+#include "I2P2_Vector.h"
+#include "I2P2_HashTable.h"
+
+namespace I2P2
+{
+  /* Unordered map from value_type to value_type on the flat hash_table in I2P2_HashTable.h. Values
+     sit in their own Vector at the slot index of their key, so probing reads only keys. Lookups take
+     any arithmetic key (see lookup_key). for_each visits the pairs in slot order. */
+  class HashMap : public container_base
+  {
+    private:
+      hash_table _table;
+      Vector _values;
+
+      template <class K>
+      size_type slot_of(const K &key) const
+      {
+        value_type k;
+        return lookup_key(key, k) ? _table.find(k) : hash_table::npos;
+      }
+
+    public:
+      HashMap() {}
+
+      // the value of key, or nullptr; valid until the next insert
+      template <class K>
+      pointer find(const K &key)
+      {
+        size_type slot = slot_of(key);
+        return slot == hash_table::npos ? nullptr : &_values[slot];
+      }
+      template <class K>
+      const_pointer find(const K &key) const
+      {
+        size_type slot = slot_of(key);
+        return slot == hash_table::npos ? nullptr : &_values[slot];
+      }
+      template <class K>
+      bool contains(const K &key) const { return slot_of(key) != hash_table::npos; }
+      // throws std::out_of_range when key is absent
+      template <class K>
+      reference at(const K &key)
+      {
+        pointer val = find(key);
+        if (val == nullptr)
+          throw std::out_of_range("HashMap::at: key not found");
+        return *val;
+      }
+      template <class K>
+      const_reference at(const K &key) const
+      {
+        const_pointer val = find(key);
+        if (val == nullptr)
+          throw std::out_of_range("HashMap::at: key not found");
+        return *val;
+      }
+      // inserts key with a value-initialized value when absent
+      reference operator[](const_reference key);
+
+      // false, leaving the old value, if key was already present
+      bool insert(const_reference key, const_reference val);
+      // true if key was new
+      bool insert_or_assign(const_reference key, const_reference val);
+      template <class K>
+      bool erase(const K &key)
+      {
+        size_type slot = slot_of(key);
+        if (slot == hash_table::npos)
+          return false;
+        _table.erase_at(slot);
+        return true;
+      }
+      template <class Func>
+      void for_each(Func func)
+      {
+        for (size_type slot = 0; slot < _table.capacity(); slot++)
+          if (_table.full(slot))
+            func(_table.key_at(slot), _values[slot]);
+      }
+
+      void reserve(size_type count) { _table.reserve(count, &_values); }
+      void rehash(size_type count) { _table.rehash(count, &_values); }
+      size_type capacity() const { return _table.capacity(); }
+      void clear() { _table.clear(); }
+      size_type size() const { return _table.size(); }
+      bool empty() const { return _table.size() == 0; }
+  };
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef I2P2_HASHSET_H
+#define I2P2_HASHSET_H
+#include "I2P2_container.h"
+#include "I2P2_HashTable.h"
+
+namespace I2P2
+{
+  /* Unordered set of value_type on the flat hash_table in I2P2_HashTable.h: no allocation per
+     element, and a lookup touches one group of control bytes and usually one key. Lookups take any
+     arithmetic key (see lookup_key). for_each visits the elements in slot order. */
+  class HashSet : public container_base
+  {
+    private:
+      hash_table _table;
+
+    public:
+      HashSet() {}
+
+      // false if key was already present
+      bool insert(const_reference key) { return _table.find_or_insert(key, nullptr).second; }
+      template <class K>
+      bool contains(const K &key) const
+      {
+        value_type k;
+        return lookup_key(key, k) && _table.find(k) != hash_table::npos;
+      }
+      template <class K>
+      size_type count(const K &key) const { return contains(key); }
+      // false if key was absent
+      template <class K>
+      bool erase(const K &key)
+      {
+        value_type k;
+        size_type slot = lookup_key(key, k) ? _table.find(k) : hash_table::npos;
+        if (slot == hash_table::npos)
+          return false;
+        _table.erase_at(slot);
+        return true;
+      }
+      template <class Func>
+      void for_each(Func func) const
+      {
+        for (size_type slot = 0; slot < _table.capacity(); slot++)
+          if (_table.full(slot))
+            func(_table.key_at(slot));
+      }
+
+      void reserve(size_type count) { _table.reserve(count, nullptr); }
+      void rehash(size_type count) { _table.rehash(count, nullptr); }
+      size_type capacity() const { return _table.capacity(); }
+      void clear() { _table.clear(); }
+      size_type size() const { return _table.size(); }
+      bool empty() const { return _table.size() == 0; }
+  };
+}  // namespace I2P2
+
+#endif
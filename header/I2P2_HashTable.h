@@ -0,0 +1,90 @@
+#ifndef I2P2_HASHTABLE_H
+#define I2P2_HASHTABLE_H
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include "I2P2_def.h"
+#include "I2P2_Vector.h"
+
+namespace I2P2
+{
+  /* Swiss-table core shared by HashSet and HashMap: open addressing over a power-of-two number of
+     slots, with one control byte per slot. A full slot's byte holds 7 bits of the key's hash, so a
+     probe compares 16 control bytes at once (one SSE2 compare where available) and touches a key
+     only on a hash match. Keys live in a Vector; HashMap passes its values Vector along so they
+     move with their keys when the table is rebuilt. Erased slots become tombstones unless no probe
+     can have passed them, and tombstones are dropped by the next rebuild. */
+  class hash_table
+  {
+    public:
+      static const size_type npos = static_cast<size_type>(-1);
+      static const size_type group_width = 16;
+
+    private:
+      std::vector<int8_t> _ctrl;   // capacity bytes, then the first group_width - 1 repeated
+      Vector _keys;
+      size_type _capacity;
+      size_type _size;
+      size_type _growth_left;      // inserts into empty slots before a rebuild; tombstones count as used
+      size_type _rebuilds;
+
+      void set_ctrl(size_type slot, int8_t h);
+      size_type find_non_full(uint64_t hash) const;
+      void resize(size_type new_capacity, Vector *values);
+
+    public:
+      hash_table();
+
+      // the smallest valid capacity that holds count elements under the 7/8 load limit
+      static size_type capacity_for(size_type count);
+      static uint64_t hash(value_type key);
+
+      size_type size() const { return _size; }
+      size_type capacity() const { return _capacity; }
+      // bytes held by the control bytes and keys
+      size_type bytes() const { return _ctrl.capacity() + _keys.capacity() * sizeof(value_type); }
+      bool full(size_type slot) const { return _ctrl[slot] >= 0; }
+      const_reference key_at(size_type slot) const { return _keys[slot]; }
+      // bumped whenever a rebuild moves keys to new slots, so callers holding slots know to look again
+      size_type rebuilds() const { return _rebuilds; }
+
+      // slot of key, or npos
+      size_type find(value_type key) const;
+      // slot of key and false, or a new slot already holding key and true
+      std::pair<size_type, bool> find_or_insert(value_type key, Vector *values);
+      void erase_at(size_type slot);
+      // room for count elements without a rebuild
+      void reserve(size_type count, Vector *values);
+      // rebuilds with capacity_for(max(count, size())), dropping tombstones; may shrink, and an empty
+      // table with count 0 releases its memory
+      void rehash(size_type count, Vector *values);
+      void clear();
+  };
+
+  /* Heterogeneous lookup: an arithmetic key of another type is looked up without an intermediate
+     conversion that could change its value. A key value_type cannot hold exactly (300 for uint8,
+     0.5 for int64) is reported as absent rather than truncated onto some other key. */
+  template <class K>
+  bool lookup_key(K key, value_type &out)
+  {
+    static_assert(std::is_arithmetic<K>::value, "heterogeneous lookup takes arithmetic keys");
+    // long double holds every 64-bit integer and double exactly
+    long double wide = key;
+    bool in_range = wide >= static_cast<long double>(std::numeric_limits<value_type>::lowest()) &&
+                    wide <= static_cast<long double>(std::numeric_limits<value_type>::max());
+    if (!in_range && !(std::numeric_limits<value_type>::has_infinity && std::isinf(wide)))
+      return false;
+    out = static_cast<value_type>(key);
+    return static_cast<long double>(out) == wide;
+  }
+  inline bool lookup_key(value_type key, value_type &out)
+  {
+    out = key;
+    return true;
+  }
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef I2P2_LRUCACHE_H
+#define I2P2_LRUCACHE_H
+#include <mutex>
+#include <memory>
+#include <vector>
+#include "I2P2_List.h"
+#include "I2P2_Vector.h"
+#include "I2P2_HashTable.h"
+
+namespace I2P2
+{
+  /* Least-recently-used cache from value_type keys to value_type values. The recency order is a
+     List whose nodes hold the keys, most recent first. A hash_table maps keys to slots, and
+     per-slot Vectors hold the value and the key's node. A hit relinks its node to the front without
+     allocating; a miss on a full cache reuses the back node for the new key. The index is sized for
+     the capacity up front, large enough that churn only ever rebuilds it in place, so a full cache
+     stays within its footprint. */
+  class LRUCache : public container_base
+  {
+    public:
+      enum capacity_unit { entries, bytes };
+
+      // the most entries whose nodes and index fit in bytes, as footprint() counts them
+      static size_type entries_for(size_type bytes);
+
+    private:
+      // the List with its nodes opened up to the cache, which relinks them directly
+      class order_list : public List
+      {
+        friend class LRUCache;
+      };
+
+      order_list _order;
+      size_type _capacity;
+      hash_table _index;
+      Vector _values;
+      std::vector<Node*> _nodes;
+      size_type _rebuilds_seen;
+
+      // index size reserved for a capacity: eviction keeps size() at or below capacity, under the
+      // 25/32 load at which a rebuild of a full index doubles it instead of clearing tombstones
+      static size_type index_size(size_type capacity) { return capacity * 32 / 25 + 1; }
+      // after a rebuild of _index, points _nodes at the new slots
+      void sync_nodes();
+
+    public:
+      // with unit bytes, holds entries_for(capacity) entries
+      explicit LRUCache(size_type capacity, capacity_unit unit = entries);
+      LRUCache(const LRUCache &rhs) = delete;
+      LRUCache &operator=(const LRUCache &rhs) = delete;
+
+      // copies the value of key to out and marks it most recent; false on a miss
+      bool get(const_reference key, reference out);
+      // the value of key, or nullptr, without changing the order; valid until the next put
+      const_pointer peek(const_reference key) const;
+      bool contains(const_reference key) const { return _index.find(key) != hash_table::npos; }
+      // stores val as most recent, evicting the least recent entry when full; true if key was new
+      bool put(const_reference key, const_reference val);
+      bool erase(const_reference key);
+      // visits entries from most to least recent
+      template <class Func>
+      void for_each(Func func) const
+      {
+        for (const Node *node = _order.head->next; node != _order.tail; node = node->next)
+          func(node->data, _values[_index.find(node->data)]);
+      }
+
+      size_type capacity() const { return _capacity; }
+      // bytes held by the nodes, the index and the per-slot arrays
+      size_type footprint() const;
+      size_type size() const final { return _order.size(); }
+      bool empty() const final { return _order.empty(); }
+      void clear();
+  };
+
+  /* LRUCache split into shards by key hash, each behind its own mutex, so threads working on
+     different keys rarely wait for each other. Recency is kept per shard, which approximates a
+     global LRU order. */
+  class ShardedLRUCache
+  {
+    private:
+      struct shard
+      {
+        std::mutex lock;
+        LRUCache cache;
+        shard(size_type capacity, LRUCache::capacity_unit unit) : cache(capacity, unit) {}
+      };
+      std::vector<std::unique_ptr<shard>> _shards;
+
+      shard &shard_of(const_reference key) const;
+
+    public:
+      // capacity is split as evenly as possible across shard_count shards
+      explicit ShardedLRUCache(size_type capacity, size_type shard_count = 16,
+                               LRUCache::capacity_unit unit = LRUCache::entries);
+
+      bool get(const_reference key, reference out);
+      bool contains(const_reference key) const;
+      bool put(const_reference key, const_reference val);
+      bool erase(const_reference key);
+      // not a snapshot: shards are counted one at a time
+      size_type size() const;
+      void clear();
+  };
+}  // namespace I2P2
+
+#endif
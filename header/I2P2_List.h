@@ -2,17 +2,55 @@
 #define I2P2_LIST_H
 #include "I2P2_container.h"
 #include "I2P2_iterator.h"
+#include "I2P2_stats.h"
+#include "I2P2_latency.h"
 
 namespace I2P2 
 {
   struct Node;
 
+  // overrides are final so calls through a List are direct; the class itself stays open
   class List : public ordered_container 
   {
     protected:
       Node* head;
       Node* tail;
       size_type _size;
+#ifdef I2P2_STATS
+      alloc_stats _stats;
+#endif
+
+      // every node goes through these two, so the statistics see each allocation
+      Node *new_node(const_reference val)
+      {
+        I2P2_STAT(count_allocation(_stats, sizeof(Node)));
+        return new Node(val);
+      }
+      void delete_node(Node *node)
+      {
+        I2P2_STAT(count_free(_stats, sizeof(Node)));
+        delete node;
+      }
+      // frees every element node and empties the list; what clear() does, without timing it
+      void free_nodes();
+      // moves node (of this list or another) in front of pos; no allocation, sizes are the caller's
+      static void relink(Node *pos, Node *node)
+      {
+        if (node == pos)
+          return;
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->prev = pos->prev;
+        node->next = pos;
+        pos->prev->next = node;
+        pos->prev = node;
+      }
+
+    public:
+#ifdef I2P2_STATS
+      // peak_capacity is the largest size reached; elements_moved stays 0, nodes never move
+      const alloc_stats &stats() const { return _stats; }
+#endif
 
   /* The following are standard methods from the STL */
     public:
@@ -20,25 +58,28 @@ namespace I2P2
       List();
       List(const List &rhs);
       List &operator=(const List &rhs);
-      iterator begin();
-      const_iterator begin() const;
-      iterator end();
-      const_iterator end() const;
-      reference front();
-      const_reference front() const;
-      reference back();
-      const_reference back() const;
-      size_type size() const;
-      void clear();
-      bool empty() const;
-      void erase(const_iterator pos);
-      void erase(const_iterator begin, const_iterator end);
-      void insert(const_iterator pos, size_type count, const_reference val);
-      void insert(const_iterator pos, const_iterator begin, const_iterator end);
-      void pop_back();
-      void pop_front();
-      void push_back(const_reference val);
-      void push_front(const_reference val);
+      iterator begin() final;
+      const_iterator begin() const final;
+      iterator end() final;
+      const_iterator end() const final;
+      reference front() final { return head->next->data; }
+      const_reference front() const final { return head->next->data; }
+      reference back() final { return tail->prev->data; }
+      const_reference back() const final { return tail->prev->data; }
+      size_type size() const final { return _size; }
+      void clear() final;
+      bool empty() const final { return _size == 0; }
+      void erase(const_iterator pos) final;
+      void erase(const_iterator begin, const_iterator end) final;
+      void insert(const_iterator pos, size_type count, const_reference val) final;
+      void insert(const_iterator pos, const_iterator begin, const_iterator end) final;
+      void pop_back() final;
+      void pop_front() final;
+      void push_back(const_reference val) final;
+      void push_front(const_reference val) final;
+
+      // moves the element at it from other (which may be *this) in front of pos, relinking its node
+      void splice(const_iterator pos, List &other, const_iterator it);
   };
 }  // namespace I2P2
 
@@ -0,0 +1,104 @@
+#ifndef I2P2_PACKEDVECTOR_H
+#define I2P2_PACKEDVECTOR_H
+#include <vector>
+#include <cstdint>
+#include "I2P2_container.h"
+
+namespace I2P2
+{
+  /* Sequence of small unsigned integers of a fixed bit width (1 to 64, set at construction), packed
+     into 64-bit words: 1-bit flags take an eighth of a uint8_t Vector, 2- to 4-bit codes a quarter to
+     a half. A field never straddles two words, so a word holds 64 / width fields and any leftover
+     high bits stay zero, as do the fields past size(). count, find_first, the bitwise operators and
+     range fills work a whole word at a time: they compare every field of a word at once with
+     shifts and masks instead of visiting elements. Elements are read as uint64_t; writes keep the
+     low width bits. */
+  class PackedVector : public container_base
+  {
+    public:
+      // what operator[] returns: a word and a field position in it
+      class element_ref
+      {
+        private:
+          uint64_t *_word;
+          unsigned _shift;
+          uint64_t _mask;
+
+        public:
+          element_ref(uint64_t *word, unsigned shift, uint64_t mask) : _word(word), _shift(shift), _mask(mask) {}
+          operator uint64_t() const { return (*_word >> _shift) & _mask; }
+          element_ref &operator=(uint64_t val)
+          {
+            *_word = (*_word & ~(_mask << _shift)) | ((val & _mask) << _shift);
+            return *this;
+          }
+          element_ref &operator=(const element_ref &rhs) { return *this = static_cast<uint64_t>(rhs); }
+      };
+
+    private:
+      std::vector<uint64_t> _words;
+      size_type _size;
+      unsigned _width;
+      unsigned _per_word;   // fields in one word
+      uint64_t _mask;       // one field's worth of ones
+      uint64_t _low;        // the lowest bit of every field in a word
+      uint64_t _high;       // the highest bit of every field in a word
+
+      unsigned shift_of(size_type pos) const { return static_cast<unsigned>(pos % _per_word) * _width; }
+      // ones over the fields of word w that hold elements
+      uint64_t live_mask(size_type w) const;
+      // per field of x, its highest bit set when the field is not zero
+      uint64_t nonzero_fields(uint64_t x) const;
+      uint64_t broadcast(uint64_t val) const { return (val & _mask) * _low; }
+      // copies count elements from src to dst within this vector, overlapping like memmove
+      void move_elements(size_type dst, size_type src, size_type count);
+      void check_same_shape(const PackedVector &rhs) const;
+
+    public:
+      // throws std::invalid_argument for a width outside 1 to 64
+      explicit PackedVector(unsigned width = 1);
+      PackedVector(size_type count, uint64_t val, unsigned width);
+
+      unsigned width() const { return _width; }
+      size_type size() const final { return _size; }
+      bool empty() const final { return _size == 0; }
+      size_type capacity() const { return _words.capacity() * _per_word; }
+      void reserve(size_type count) { _words.reserve((count + _per_word - 1) / _per_word); }
+      void resize(size_type count, uint64_t val = 0);
+      void clear();
+      // the packed words; size() elements over word_count() words
+      const uint64_t *data() const { return _words.data(); }
+      size_type word_count() const { return _words.size(); }
+
+      uint64_t operator[](size_type pos) const { return (_words[pos / _per_word] >> shift_of(pos)) & _mask; }
+      element_ref operator[](size_type pos) { return element_ref(&_words[pos / _per_word], shift_of(pos), _mask); }
+      uint64_t front() const { return (*this)[0]; }
+      uint64_t back() const { return (*this)[_size - 1]; }
+
+      void push_back(uint64_t val);
+      // as with Vector, popping an empty vector, inserting past the end and erasing a range that is
+      // empty or runs past the end do nothing
+      void pop_back();
+      void insert(size_type pos, size_type count, uint64_t val);
+      void insert(size_type pos, uint64_t val) { insert(pos, 1, val); }
+      void erase(size_type first, size_type last);
+      void erase(size_type pos) { erase(pos, pos + 1); }
+
+      // elements [first, last) become val / zero
+      void set(size_type first, size_type last, uint64_t val);
+      void reset(size_type first, size_type last) { set(first, last, 0); }
+      // how many elements equal val; count() counts set flags
+      size_type count(uint64_t val = 1) const;
+      // position of the first element at or after from that equals val, or size()
+      size_type find_first(uint64_t val = 1, size_type from = 0) const;
+
+      // field-wise over two vectors of the same width and size; throws std::invalid_argument otherwise
+      PackedVector &operator&=(const PackedVector &rhs);
+      PackedVector &operator|=(const PackedVector &rhs);
+      PackedVector &operator^=(const PackedVector &rhs);
+      // complements every element
+      void flip();
+  };
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef I2P2_PERSISTENTVECTOR_H
+#define I2P2_PERSISTENTVECTOR_H
+#include "I2P2_container.h"
+#include "I2P2_Vector.h"
+
+namespace I2P2
+{
+  struct pvec_node;
+
+  /* Immutable sequence with structural sharing. Elements sit in leaf chunks of a height-balanced
+     tree of reference-counted nodes, so every update copies one root-to-leaf path and returns a
+     new version in O(log n) while all older versions stay valid. Versions are safe to share
+     between threads. */
+  class PersistentVector : public container_base
+  {
+    public:
+      static const size_type leaf_capacity = 256 / sizeof(value_type);
+
+      /* Mutable batch builder. Nodes that only the transient owns are updated in place: a full
+         chunk of pushes is linked onto the owned right spine with one new branch and in-place
+         rotations, so a push_back costs O(1) plus an O(log n) spine walk shared by leaf_capacity
+         pushes. */
+      class transient
+      {
+        private:
+          pvec_node* root;
+          value_type tail[leaf_capacity];
+          size_type tail_size;
+          void flush();
+        public:
+          ~transient();
+          transient();
+          explicit transient(const PersistentVector &base);
+          transient(const transient &rhs) = delete;
+          transient &operator=(const transient &rhs) = delete;
+          size_type size() const;
+          const_reference operator[](size_type pos) const;
+          void push_back(const_reference val);
+          void set(size_type pos, const_reference val);
+          PersistentVector persistent();
+      };
+
+    private:
+      pvec_node* root;
+      explicit PersistentVector(pvec_node* r);
+
+    public:
+      ~PersistentVector();
+      PersistentVector();
+      PersistentVector(const PersistentVector &rhs);
+      explicit PersistentVector(const Vector &vec);
+      PersistentVector &operator=(const PersistentVector &rhs);
+      size_type size() const;
+      bool empty() const;
+      const_reference operator[](size_type pos) const;
+      const_reference front() const;
+      const_reference back() const;
+      PersistentVector set(size_type pos, const_reference val) const;
+      PersistentVector push_back(const_reference val) const;
+      PersistentVector concat(const PersistentVector &rhs) const;
+      PersistentVector slice(size_type begin, size_type end) const;
+      Vector to_vector() const;
+      const_pointer chunk(size_type pos, size_type &count) const;
+      template <class Func>
+      void for_each(Func func) const;
+  };
+
+  template <class Func>
+  void PersistentVector::for_each(Func func) const
+  {
+    size_type pos = 0, count = 0;
+    while (pos < size())
+    {
+      const_pointer data = chunk(pos, count);
+      for (size_type i = 0; i < count; i++)
+        func(data[i]);
+      pos += count;
+    }
+  }
+}  // namespace I2P2
+
+#endif
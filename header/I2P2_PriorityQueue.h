@@ -0,0 +1,104 @@
+#ifndef I2P2_PRIORITYQUEUE_H
+#define I2P2_PRIORITYQUEUE_H
+#include <vector>
+#include "I2P2_container.h"
+#include "I2P2_Vector.h"
+#include "I2P2_Span.h"
+
+namespace I2P2
+{
+  enum heap_order { max_first, min_first };
+  struct heap_kernel;
+
+  /* Priority queue over a d-ary heap in a Vector: the children of position i are d * i + 1 to
+     d * i + d. With the default d = 4 a node's children usually share one cache line and the tree is
+     half as deep as a binary heap, so pop reads fewer lines. Elements are moved into a hole instead
+     of swapped, pop walks the hole down to a leaf before placing the last element (which usually
+     belongs near the bottom), and nothing goes through the virtual iterators. */
+
+  class PriorityQueue : public container_base
+  {
+    private:
+      Vector _heap;
+      size_type _arity;
+      heap_order _order;
+      // the sift loops compiled for this order, and for this arity when it is 2, 4 or 8
+      const heap_kernel *_kernel;
+
+      void make_heap();
+
+    public:
+      // throws std::invalid_argument for an arity below 2
+      explicit PriorityQueue(size_type arity = 4, heap_order order = max_first);
+      PriorityQueue(VectorView src, size_type arity = 4, heap_order order = max_first);
+
+      // the queue must not be empty
+      const_reference top() const { return _heap[0]; }
+      void push(const_reference val);
+      // does nothing on an empty queue
+      void pop();
+      // push(val) then pop(), returning what was popped; val itself when it would be the top
+      value_type push_pop(value_type val);
+      // replaces the contents with a copy of src, ordered in O(n)
+      void assign(VectorView src);
+      // takes over the buffer of src, which is left empty, and orders it in O(n)
+      void heapify(Vector &src);
+
+      size_type arity() const { return _arity; }
+      heap_order order() const { return _order; }
+      // the heap array, top first
+      VectorView view() const { return VectorView(_heap.data(), _heap.size()); }
+      void reserve(size_type count) { _heap.reserve(count); }
+      void clear() { _heap.clear(); }
+      size_type size() const final { return _heap.size(); }
+      bool empty() const final { return _heap.empty(); }
+  };
+
+  /* d-ary heap of ids 0 to n - 1, each with a priority, that tracks where every id sits so an id's
+     priority can be changed in place (decrease-key) or the id removed, in O(log n). Priorities are
+     kept in heap order next to the ids, so sifting compares without an extra indirection. */
+  class IndexedPriorityQueue : public container_base
+  {
+    public:
+      static const size_type npos = static_cast<size_type>(-1);
+
+    private:
+      Vector _keys;                   // priority at each heap position
+      std::vector<size_type> _ids;    // id at each heap position
+      std::vector<size_type> _pos;    // heap position of each id, or npos
+      size_type _arity;
+      heap_order _order;
+
+      bool before(value_type a, value_type b) const { return _order == max_first ? b < a : a < b; }
+      void place(size_type pos, value_type key, size_type id);
+      void sift_up(size_type pos, value_type key, size_type id);
+      void sift_down(size_type pos, value_type key, size_type id);
+      void remove_at(size_type pos);
+
+    public:
+      // throws std::invalid_argument for an arity below 2
+      explicit IndexedPriorityQueue(size_type arity = 4, heap_order order = min_first);
+
+      // the queue must not be empty
+      size_type top() const { return _ids[0]; }
+      const_reference top_priority() const { return _keys[0]; }
+      bool contains(size_type id) const { return id < _pos.size() && _pos[id] != npos; }
+      // the priority of an id in the queue
+      const_reference priority(size_type id) const { return _keys[_pos[id]]; }
+      // adds id, or changes its priority when it is already in the queue
+      void push(size_type id, const_reference priority);
+      // moves an id in the queue up or down to match its new priority
+      void update(size_type id, const_reference priority);
+      // does nothing on an empty queue
+      void pop();
+      // false if id was not in the queue
+      bool erase(size_type id);
+
+      size_type arity() const { return _arity; }
+      void clear();
+      size_type size() const final { return _ids.size(); }
+      bool empty() const final { return _ids.empty(); }
+  };
+}  // namespace I2P2
+
+#endif
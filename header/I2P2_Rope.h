@@ -0,0 +1,73 @@
+#ifndef I2P2_ROPE_H
+#define I2P2_ROPE_H
+#include "I2P2_container.h"
+#include "I2P2_iterator.h"
+
+namespace I2P2
+{
+  struct rope_node;
+
+  /* Sequence stored as contiguous leaf chunks under a B-tree whose inner nodes keep the element
+     count of every child. insert, erase and operator[] at any index are O(log n); use chunk or
+     for_each for sequential scans, which read whole leaves instead of descending per element. */
+  class Rope : public randomaccess_container
+  {
+    public:
+      static const size_type leaf_capacity = 512 / sizeof(value_type);
+      static const size_type fanout = 16;
+
+    private:
+      rope_node* root;
+
+      void insert_one(size_type pos, const_reference val);
+      void erase_one(size_type pos);
+
+    public:
+      ~Rope();
+      Rope();
+      Rope(const Rope &rhs);
+      Rope &operator=(const Rope &rhs);
+      const_pointer chunk(size_type pos, size_type &count) const;
+      template <class Func>
+      void for_each(Func func) const;
+
+  /* The following are standard methods from the STL */
+    public:
+      iterator begin();
+      const_iterator begin() const;
+      iterator end();
+      const_iterator end() const;
+      reference front();
+      const_reference front() const;
+      reference back();
+      const_reference back() const;
+      reference operator[](size_type pos);
+      const_reference operator[](size_type pos) const;
+      size_type size() const;
+      void clear();
+      bool empty() const;
+      void erase(const_iterator pos);
+      void erase(const_iterator begin, const_iterator end);
+      void insert(const_iterator pos, size_type count, const_reference val);
+      void insert(const_iterator pos, const_iterator begin, const_iterator end);
+      void pop_back();
+      void pop_front();
+      void push_back(const_reference val);
+      void push_front(const_reference val);
+  };
+
+  template <class Func>
+  void Rope::for_each(Func func) const
+  {
+    size_type pos = 0, count = 0;
+    while (pos < size())
+    {
+      const_pointer data = chunk(pos, count);
+      for (size_type i = 0; i < count; i++)
+        func(data[i]);
+      pos += count;
+    }
+  }
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef I2P2_SPSCQUEUE_H
+#define I2P2_SPSCQUEUE_H
+#include <atomic>
+#include "I2P2_Vector.h"
+#include "I2P2_Span.h"
+
+namespace I2P2
+{
+  /* Bounded lock-free queue for exactly one producer thread and one consumer thread.
+     Storage is a power-of-two Vector; head and tail live on separate cache lines. */
+  class SPSCQueue
+  {
+    private:
+      Vector buffer;
+      pointer slots;
+      size_type mask;
+
+      alignas(64) std::atomic<size_type> head;  // written by the consumer only
+      size_type cached_tail;                    // consumer's last view of tail
+      alignas(64) std::atomic<size_type> tail;  // written by the producer only
+      size_type cached_head;                    // producer's last view of head
+      char pad[64 - sizeof(size_type)];
+
+    public:
+      explicit SPSCQueue(size_type min_capacity);
+      SPSCQueue(const SPSCQueue &rhs) = delete;
+      SPSCQueue &operator=(const SPSCQueue &rhs) = delete;
+      size_type capacity() const;
+      size_type size() const;
+      bool empty() const;
+
+    /* Producer side */
+      bool push(const_reference val);
+      size_type push_n(const_pointer src, size_type count);
+      size_type push_n(VectorView src);
+
+    /* Consumer side */
+      bool pop(reference val);
+      size_type pop_n(pointer dst, size_type count);
+      size_type pop_n(Span dst);
+  };
+}  // namespace I2P2
+
+#endif
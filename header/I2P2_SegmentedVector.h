@@ -0,0 +1,77 @@
+#ifndef I2P2_SEGMENTEDVECTOR_H
+#define I2P2_SEGMENTEDVECTOR_H
+#include "I2P2_container.h"
+#include "I2P2_iterator.h"
+
+namespace I2P2
+{
+  /* Vector that grows by adding segments instead of relocating: segment k holds
+     first_segment << k elements, so push_back is O(1), growth never moves an element and
+     pointers stay valid across appends. operator[] maps an index to its segment with one bit scan. */
+  class SegmentedVector : public randomaccess_container
+  {
+    public:
+      static const size_type first_segment = 32;
+      static const size_type max_segments = 48;
+
+    private:
+      pointer segments[max_segments];
+      size_type segment_count;
+      size_type _size;
+
+      void add_segment();
+      void grow_to(size_type count);
+      pointer locate(size_type pos) const;
+
+    public:
+      ~SegmentedVector();
+      SegmentedVector();
+      SegmentedVector(const SegmentedVector &rhs);
+      SegmentedVector &operator=(const SegmentedVector &rhs);
+      const_pointer chunk(size_type pos, size_type &count) const;
+      template <class Func>
+      void for_each(Func func) const;
+
+  /* The following are standard methods from the STL */
+    public:
+      iterator begin();
+      const_iterator begin() const;
+      iterator end();
+      const_iterator end() const;
+      reference front();
+      const_reference front() const;
+      reference back();
+      const_reference back() const;
+      reference operator[](size_type pos);
+      const_reference operator[](size_type pos) const;
+      size_type capacity() const;
+      size_type size() const;
+      void clear();
+      bool empty() const;
+      void erase(const_iterator pos);
+      void erase(const_iterator begin, const_iterator end);
+      void insert(const_iterator pos, size_type count, const_reference val);
+      void insert(const_iterator pos, const_iterator begin, const_iterator end);
+      void pop_back();
+      void pop_front();
+      void push_back(const_reference val);
+      void push_front(const_reference val);
+      void reserve(size_type new_capacity);
+      void shrink_to_fit();
+  };
+
+  template <class Func>
+  void SegmentedVector::for_each(Func func) const
+  {
+    size_type pos = 0, count = 0;
+    while (pos < size())
+    {
+      const_pointer data = chunk(pos, count);
+      for (size_type i = 0; i < count; i++)
+        func(data[i]);
+      pos += count;
+    }
+  }
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef I2P2_SLOTMAP_H
+#define I2P2_SLOTMAP_H
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include "I2P2_container.h"
+#include "I2P2_Vector.h"
+#include "I2P2_Span.h"
+
+namespace I2P2
+{
+  // names an element of a SlotMap; stays valid until that element is erased, whatever else changes
+  struct slot_handle
+  {
+    uint32_t index;
+    uint32_t generation;
+  };
+  inline bool operator==(slot_handle a, slot_handle b) { return a.index == b.index && a.generation == b.generation; }
+  inline bool operator!=(slot_handle a, slot_handle b) { return !(a == b); }
+
+  /* Values packed densely in a Vector, reached through stable handles. A handle names a slot in an
+     indirection table. The slot records where its value sits in the dense array and a generation
+     that changes on every insert and erase, so a handle to an erased element no longer matches and
+     is rejected. Erase moves the last value into the hole and repoints its slot; freed slots are
+     reused through a free list. Insert, erase and lookup are O(1), and iterating over values() is a
+     plain loop over contiguous memory. */
+  class SlotMap : public container_base
+  {
+    private:
+      struct slot
+      {
+        uint32_t generation;   // odd while the slot holds a value
+        uint32_t link;         // dense index while occupied, next free slot while free
+      };
+      static const uint32_t no_slot = static_cast<uint32_t>(-1);
+
+      Vector _values;
+      std::vector<uint32_t> _owner;   // slot of each dense value
+      std::vector<slot> _slots;
+      uint32_t _free;
+
+      void release(uint32_t index);
+
+    public:
+      SlotMap() : _free(no_slot) {}
+
+      slot_handle insert(const_reference val);
+      // false for a stale or foreign handle
+      bool erase(slot_handle handle);
+      bool contains(slot_handle handle) const
+      {
+        // free slots have even generations, so a zeroed handle never matches
+        return (handle.generation & 1) && handle.index < _slots.size() &&
+               _slots[handle.index].generation == handle.generation;
+      }
+      // the value of handle, or nullptr; valid until the next insert or erase
+      pointer get(slot_handle handle) { return contains(handle) ? &_values[_slots[handle.index].link] : nullptr; }
+      const_pointer get(slot_handle handle) const
+      {
+        return contains(handle) ? &_values[_slots[handle.index].link] : nullptr;
+      }
+      // throws std::out_of_range for a stale handle
+      reference at(slot_handle handle)
+      {
+        pointer val = get(handle);
+        if (val == nullptr)
+          throw std::out_of_range("SlotMap::at: stale handle");
+        return *val;
+      }
+      const_reference at(slot_handle handle) const
+      {
+        const_pointer val = get(handle);
+        if (val == nullptr)
+          throw std::out_of_range("SlotMap::at: stale handle");
+        return *val;
+      }
+      // unchecked
+      reference operator[](slot_handle handle) { return _values[_slots[handle.index].link]; }
+      const_reference operator[](slot_handle handle) const { return _values[_slots[handle.index].link]; }
+
+      // the values in dense order; erase reorders them
+      Span values() { return Span(_values); }
+      VectorView values() const { return VectorView(_values); }
+      // handle of the value at dense position pos
+      slot_handle handle_at(size_type pos) const
+      {
+        slot_handle handle = {_owner[pos], _slots[_owner[pos]].generation};
+        return handle;
+      }
+
+      void reserve(size_type count);
+      // invalidates every handle; the slots are kept for reuse
+      void clear();
+      size_type size() const final { return _values.size(); }
+      bool empty() const final { return _values.empty(); }
+  };
+}  // namespace I2P2
+
+#endif
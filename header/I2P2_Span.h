@@ -0,0 +1,135 @@
+#ifndef I2P2_SPAN_H
+#define I2P2_SPAN_H
+#include "I2P2_def.h"
+#include "I2P2_Vector.h"
+
+namespace I2P2
+{
+  /* Non-owning views over contiguous elements: a pointer plus a length, passed by value.
+     Slicing never allocates and nothing is virtual; begin()/end() are raw pointers.
+     A view does not keep its Vector alive and is invalidated when the Vector reallocates. */
+  class StridedView;
+  class StridedSpan;
+
+  // read-only view
+  class VectorView
+  {
+    private:
+      const_pointer _data;
+      size_type _size;
+
+    public:
+      VectorView() : _data(nullptr), _size(0) {}
+      VectorView(const_pointer data, size_type count) : _data(data), _size(count) {}
+      VectorView(const Vector &vec) : _data(vec.data()), _size(vec.size()) {}
+      const_pointer data() const { return _data; }
+      size_type size() const { return _size; }
+      bool empty() const { return _size == 0; }
+      const_pointer begin() const { return _data; }
+      const_pointer end() const { return _data + _size; }
+      const_reference operator[](size_type pos) const { return _data[pos]; }
+      const_reference front() const { return _data[0]; }
+      const_reference back() const { return _data[_size - 1]; }
+      VectorView subspan(size_type offset, size_type count) const { return VectorView(_data + offset, count); }
+      VectorView subspan(size_type offset) const { return VectorView(_data + offset, _size - offset); }
+      VectorView first(size_type count) const { return VectorView(_data, count); }
+      VectorView last(size_type count) const { return VectorView(_data + _size - count, count); }
+      // every step-th element, starting with the first
+      StridedView strided(size_type step) const;
+  };
+
+  // mutable view
+  class Span
+  {
+    private:
+      pointer _data;
+      size_type _size;
+
+    public:
+      Span() : _data(nullptr), _size(0) {}
+      Span(pointer data, size_type count) : _data(data), _size(count) {}
+      Span(Vector &vec) : _data(vec.data()), _size(vec.size()) {}
+      operator VectorView() const { return VectorView(_data, _size); }
+      pointer data() const { return _data; }
+      size_type size() const { return _size; }
+      bool empty() const { return _size == 0; }
+      pointer begin() const { return _data; }
+      pointer end() const { return _data + _size; }
+      reference operator[](size_type pos) const { return _data[pos]; }
+      reference front() const { return _data[0]; }
+      reference back() const { return _data[_size - 1]; }
+      Span subspan(size_type offset, size_type count) const { return Span(_data + offset, count); }
+      Span subspan(size_type offset) const { return Span(_data + offset, _size - offset); }
+      Span first(size_type count) const { return Span(_data, count); }
+      Span last(size_type count) const { return Span(_data + _size - count, count); }
+      StridedSpan strided(size_type step) const;
+  };
+
+  // read-only view of count elements that are step elements apart
+  class StridedView
+  {
+    private:
+      const_pointer _data;
+      size_type _size;
+      size_type _step;
+
+    public:
+      StridedView() : _data(nullptr), _size(0), _step(1) {}
+      StridedView(const_pointer data, size_type count, size_type step) : _data(data), _size(count), _step(step) {}
+      const_pointer data() const { return _data; }
+      size_type size() const { return _size; }
+      size_type step() const { return _step; }
+      bool empty() const { return _size == 0; }
+      const_reference operator[](size_type pos) const { return _data[pos * _step]; }
+      const_reference front() const { return _data[0]; }
+      const_reference back() const { return _data[(_size - 1) * _step]; }
+      StridedView subspan(size_type offset, size_type count) const
+      {
+        return StridedView(_data + offset * _step, count, _step);
+      }
+      StridedView strided(size_type step) const
+      {
+        return StridedView(_data, _size == 0 ? 0 : (_size - 1) / step + 1, _step * step);
+      }
+  };
+
+  // mutable view of count elements that are step elements apart
+  class StridedSpan
+  {
+    private:
+      pointer _data;
+      size_type _size;
+      size_type _step;
+
+    public:
+      StridedSpan() : _data(nullptr), _size(0), _step(1) {}
+      StridedSpan(pointer data, size_type count, size_type step) : _data(data), _size(count), _step(step) {}
+      operator StridedView() const { return StridedView(_data, _size, _step); }
+      pointer data() const { return _data; }
+      size_type size() const { return _size; }
+      size_type step() const { return _step; }
+      bool empty() const { return _size == 0; }
+      reference operator[](size_type pos) const { return _data[pos * _step]; }
+      reference front() const { return _data[0]; }
+      reference back() const { return _data[(_size - 1) * _step]; }
+      StridedSpan subspan(size_type offset, size_type count) const
+      {
+        return StridedSpan(_data + offset * _step, count, _step);
+      }
+      StridedSpan strided(size_type step) const
+      {
+        return StridedSpan(_data, _size == 0 ? 0 : (_size - 1) / step + 1, _step * step);
+      }
+  };
+
+  inline StridedView VectorView::strided(size_type step) const
+  {
+    return StridedView(_data, _size == 0 ? 0 : (_size - 1) / step + 1, step);
+  }
+  inline StridedSpan Span::strided(size_type step) const
+  {
+    return StridedSpan(_data, _size == 0 ? 0 : (_size - 1) / step + 1, step);
+  }
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef I2P2_STATICVECTOR_H
+#define I2P2_STATICVECTOR_H
+#include <stdexcept>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include "I2P2_iterator.h"
+#include "I2P2_static_container.h"
+
+namespace I2P2
+{
+  /* Vector with inline storage for at most N elements and no heap allocation.
+     Growing past N throws std::length_error (try_push_back reports it instead).
+     Under C++20 everything except the iterator-based members is constexpr, so tables can be
+     built at compile time with push_back/operator[]. Dispatch is static (no vtable); wrap it in
+     randomaccess_adapter for a randomaccess_container. */
+  template <size_type N>
+  class StaticVector : public static_randomaccess_container<StaticVector<N> >
+  {
+    static_assert(N > 0, "StaticVector needs a non-zero capacity");
+
+    private:
+      value_type _data[N];
+      size_type _size;
+
+      I2P2_CONSTEXPR20 void check_room(size_type count) const
+      {
+        if (N - _size < count)
+          throw std::length_error("StaticVector capacity exceeded");
+      }
+
+    public:
+      I2P2_CONSTEXPR20 StaticVector() : _size(0)
+      {
+#if __cplusplus >= 202002L
+        // constant evaluation may not leave storage indeterminate
+        if (std::is_constant_evaluated())
+          for (size_type i = 0; i < N; i++)
+            _data[i] = value_type(0);
+#endif
+      }
+      I2P2_CONSTEXPR20 StaticVector(std::initializer_list<value_type> init) : StaticVector()
+      {
+        check_room(init.size());
+        for (const_reference val : init)
+          _data[_size++] = val;
+      }
+      I2P2_CONSTEXPR20 StaticVector(const StaticVector &rhs) : StaticVector()
+      {
+        for (size_type i = 0; i < rhs._size; i++)
+          _data[i] = rhs._data[i];
+        _size = rhs._size;
+      }
+      I2P2_CONSTEXPR20 StaticVector &operator=(const StaticVector &rhs)
+      {
+        for (size_type i = 0; i < rhs._size; i++)
+          _data[i] = rhs._data[i];
+        _size = rhs._size;
+        return *this;
+      }
+      I2P2_CONSTEXPR20 pointer data() { return _data; }
+      I2P2_CONSTEXPR20 const_pointer data() const { return _data; }
+      I2P2_CONSTEXPR20 bool full() const { return _size == N; }
+      I2P2_CONSTEXPR20 bool try_push_back(const_reference val)
+      {
+        if (_size == N)
+          return false;
+        _data[_size++] = val;
+        return true;
+      }
+
+  /* The following are standard methods from the STL */
+    public:
+      iterator begin()
+      {
+        vector_iterator start_ptr = vector_iterator(_data);
+        return iterator(&start_ptr);
+      }
+      const_iterator begin() const
+      {
+        vector_iterator start_ptr = vector_iterator(const_cast<pointer>(_data));
+        return const_iterator(&start_ptr);
+      }
+      iterator end()
+      {
+        vector_iterator last_ptr = vector_iterator(_data + _size);
+        return iterator(&last_ptr);
+      }
+      const_iterator end() const
+      {
+        vector_iterator last_ptr = vector_iterator(const_cast<pointer>(_data) + _size);
+        return const_iterator(&last_ptr);
+      }
+      I2P2_CONSTEXPR20 reference operator[](size_type pos) { return _data[pos]; }
+      I2P2_CONSTEXPR20 const_reference operator[](size_type pos) const { return _data[pos]; }
+      I2P2_CONSTEXPR20 size_type capacity() const { return N; }
+      I2P2_CONSTEXPR20 size_type size() const { return _size; }
+      I2P2_CONSTEXPR20 void clear() { _size = 0; }
+      void erase(const_iterator pos)
+      {
+        size_type position = pos - begin();
+        if (position >= _size)
+          return;
+        for (size_type i = position; i + 1 < _size; i++)
+          _data[i] = _data[i + 1];
+        _size--;
+      }
+      void erase(const_iterator begin, const_iterator end)
+      {
+        size_type start = begin - this->begin();
+        size_type count = end - begin;
+        for (size_type i = start; i + count < _size; i++)
+          _data[i] = _data[i + count];
+        _size -= count;
+      }
+      void insert(const_iterator pos, size_type count, const_reference val)
+      {
+        size_type position = pos - begin();
+        if (count == 0 || position > _size)
+          return;
+        check_room(count);
+
+        value_type copy = val;
+        for (size_type i = _size; i > position; i--)
+          _data[i - 1 + count] = _data[i - 1];
+        for (size_type i = 0; i < count; i++)
+          _data[position + i] = copy;
+        _size += count;
+      }
+      void insert(const_iterator pos, const_iterator begin, const_iterator end)
+      {
+        size_type position = pos - this->begin();
+        size_type count = end - begin;
+        if (count == 0 || position > _size)
+          return;
+        check_room(count);
+
+        // a source range inside this vector is found again after the shift: the part at or past
+        // position has moved up by count, and nothing of it is read from the gap
+        const_pointer src = &*begin;
+        bool inside = !std::less<const_pointer>()(src, _data) && std::less<const_pointer>()(src, _data + _size);
+        size_type src_pos = inside ? static_cast<size_type>(src - _data) : 0;
+
+        for (size_type i = _size; i > position; i--)
+          _data[i - 1 + count] = _data[i - 1];
+        if (inside)
+          for (size_type i = 0; i < count; i++)
+            _data[position + i] = _data[src_pos + i < position ? src_pos + i : src_pos + i + count];
+        else
+          for (size_type i = 0; i < count; i++, ++begin)
+            _data[position + i] = *begin;
+        _size += count;
+      }
+      I2P2_CONSTEXPR20 void pop_back()
+      {
+        if (_size != 0)
+          _size--;
+      }
+      I2P2_CONSTEXPR20 void push_back(const_reference val)
+      {
+        check_room(1);
+        _data[_size++] = val;
+      }
+  };
+}  // namespace I2P2
+
+#endif
@@ -2,9 +2,19 @@
 #define I2P2_VECTOR_H
 #include "I2P2_container.h"
 #include "I2P2_iterator.h"
+#include "I2P2_stats.h"
+#include "I2P2_latency.h"
+#include <new>
+#include <utility>
+#include <sys/types.h>
 
 namespace I2P2 
 {
+class VectorView;
+class StridedView;
+
+/* Overrides are final and the hot accessors are defined here, so calls through a Vector (rather
+   than a container base) are direct and inline. */
 class Vector : public randomaccess_container 
 {
  private:
@@ -12,36 +22,106 @@ class Vector : public randomaccess_container
     pointer p_last;
     pointer p_end;
 
+#ifdef I2P2_STATS
+    alloc_stats _stats;
+#endif
+
+    void grow(size_type new_size);
+    void reset_storage(size_type new_capacity);
+    // the loop behind append_from_fd; read(buf, len, bytes_so_far) is one read() or pread()
+    template <class Read>
+    ssize_t fill_from_fd(size_type count, Read read);
+
+ public:
+    explicit Vector(size_type count);
+    Vector(size_type count, const_reference val);
+    Vector(const_iterator begin, const_iterator end);
+    void assign(size_type count, const_reference val);
+    void assign(const_iterator begin, const_iterator end);
+    void resize(size_type count);
+    void resize(size_type count, const_reference val);
+    // grows without writing the new elements; value_type is trivial, so they are ready to be filled
+    void resize_uninitialized(size_type count);
+    pointer data() { return p_begin; }
+    const_pointer data() const { return p_begin; }
+    // exchanges buffers, no element is copied; the stats go with their buffers, so each buffer's
+    // free is counted where its allocation was
+    void swap(Vector &rhs)
+    {
+      std::swap(p_begin, rhs.p_begin);
+      std::swap(p_last, rhs.p_last);
+      std::swap(p_end, rhs.p_end);
+#ifdef I2P2_STATS
+      std::swap(_stats, rhs._stats);
+#endif
+    }
+    void append(const_pointer src, size_type count);
+    /* read()/pread() up to count elements straight into the tail, until count arrive or end of file.
+       Returns the bytes read, like read(), or -1 with errno set when the first read fails (EINTR is
+       retried); an error after some bytes stops the call and is reported by the next one. Whole
+       elements are appended; the bytes % sizeof(value_type) bytes of a trailing partial element are
+       left just past the last element, at data() + size(). */
+    ssize_t append_from_fd(int fd, size_type count);
+    ssize_t append_from_fd(int fd, size_type count, off_t offset);
+
+  /* Span overloads (see I2P2_Span.h): contiguous copies, no iterator allocation */
+    explicit Vector(VectorView src);
+    void assign(VectorView src);
+    void append(VectorView src);
+    void append(StridedView src);
+    void insert(const_iterator pos, VectorView src);
+#ifdef I2P2_STATS
+    // this vector's share of the counters in I2P2_stats.h
+    const alloc_stats &stats() const { return _stats; }
+#endif
+
   /* The following are standard methods from the STL */
  public:
     ~Vector();
     Vector();
     Vector(const Vector &rhs);
     Vector &operator=(const Vector &rhs);
-    iterator begin();
-    const_iterator begin() const;
-    iterator end();
-    const_iterator end() const;
-    reference front();
-    const_reference front() const;
-    reference back();
-    const_reference back() const;
-    reference operator[](size_type pos);
-    const_reference operator[](size_type pos) const;
-    size_type capacity() const;
-    size_type size() const;
-    void clear();
-    bool empty() const;
-    void erase(const_iterator pos);
-    void erase(const_iterator begin, const_iterator end);
-    void insert(const_iterator pos, size_type count, const_reference val);
-    void insert(const_iterator pos, const_iterator begin, const_iterator end);
-    void pop_back();
-    void pop_front();
-    void push_back(const_reference val);
-    void push_front(const_reference val);
-    void reserve(size_type new_capacity);
-    void shrink_to_fit();
+    iterator begin() final;
+    const_iterator begin() const final;
+    iterator end() final;
+    const_iterator end() const final;
+    reference front() final { return *p_begin; }
+    const_reference front() const final { return *p_begin; }
+    reference back() final { return p_last[-1]; }
+    const_reference back() const final { return p_last[-1]; }
+    reference operator[](size_type pos) final { return p_begin[pos]; }
+    const_reference operator[](size_type pos) const final { return p_begin[pos]; }
+    size_type capacity() const final { return p_end - p_begin; }
+    size_type size() const final { return p_last - p_begin; }
+    void clear() final;
+    bool empty() const final { return p_last == p_begin; }
+    void erase(const_iterator pos) final;
+    void erase(const_iterator begin, const_iterator end) final;
+    void insert(const_iterator pos, size_type count, const_reference val) final;
+    void insert(const_iterator pos, const_iterator begin, const_iterator end) final;
+    void pop_back() final
+    {
+      I2P2_LATENCY_SCOPE(latency_pop_back);
+      if (p_last != p_begin)
+        (--p_last)->~value_type();
+    }
+    void pop_front() final;
+    void push_back(const_reference val) final
+    {
+      I2P2_LATENCY_SCOPE(latency_push_back);
+      if (p_last == p_end)
+      {
+        // val may live in the buffer that grow() releases
+        value_type copy = val;
+        grow(size() + 1);
+        new (p_last++) value_type(copy);
+        return;
+      }
+      new (p_last++) value_type(val);
+    }
+    void push_front(const_reference val) final;
+    void reserve(size_type new_capacity) final;
+    void shrink_to_fit() final;
   };
 }  // namespace I2P2
 
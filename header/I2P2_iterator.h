@@ -5,6 +5,8 @@
 
 namespace I2P2 
 {
+  struct randomaccess_container;
+
   struct Node
   {
     Node *prev, *next;
@@ -25,6 +27,7 @@ namespace I2P2
     virtual iterator_impl_base &operator-=(difference_type offset) = 0;
     virtual Node* node_ref() const = 0;
     virtual pointer ptr_ref() const = 0;
+    virtual difference_type index_ref() const = 0;
     virtual bool operator==(const iterator_impl_base &rhs) const = 0;
     virtual bool operator!=(const iterator_impl_base &rhs) const = 0;
     virtual bool operator<(const iterator_impl_base &rhs) const = 0;
@@ -57,6 +60,7 @@ namespace I2P2
       reference operator[](difference_type offset) const;
       Node* node_ref() const {return nullptr;}
       pointer ptr_ref() const {return vec;}
+      difference_type index_ref() const {return 0;}
   };
 
   class list_iterator : public iterator_impl_base 
@@ -83,6 +87,36 @@ namespace I2P2
       reference operator[](difference_type offset) const;
       Node* node_ref() const {return _node;}
       pointer ptr_ref() const {return nullptr;}
+      difference_type index_ref() const {return 0;}
+  };
+
+  /* Position-based iterator for randomaccess containers whose storage is not one contiguous block */
+  class index_iterator : public iterator_impl_base 
+  {
+    protected:
+      randomaccess_container* _con;
+      difference_type _pos;
+    public:
+      index_iterator() : _con(nullptr), _pos(0) {}
+      index_iterator(randomaccess_container *c, difference_type pos) : _con(c), _pos(pos) {} 
+      iterator_impl_base &operator++();
+      iterator_impl_base &operator--();
+      iterator_impl_base &operator+=(difference_type offset);
+      iterator_impl_base &operator-=(difference_type offset);
+      iterator_impl_base* clone() const;
+      bool operator==(const iterator_impl_base &rhs) const;
+      bool operator!=(const iterator_impl_base &rhs) const;
+      bool operator<(const iterator_impl_base &rhs) const;
+      bool operator>(const iterator_impl_base &rhs) const;
+      bool operator<=(const iterator_impl_base &rhs) const;
+      bool operator>=(const iterator_impl_base &rhs) const;
+      difference_type operator-(const iterator_impl_base &rhs) const;
+      pointer operator->() const;
+      reference operator*() const;
+      reference operator[](difference_type offset) const;
+      Node* node_ref() const {return nullptr;}
+      pointer ptr_ref() const {return nullptr;}
+      difference_type index_ref() const {return _pos;}
   };
 
   class const_iterator 
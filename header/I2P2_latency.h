@@ -0,0 +1,113 @@
+#ifndef I2P2_LATENCY_H
+#define I2P2_LATENCY_H
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include "I2P2_def.h"
+
+/* Latency histograms for the Vector and List mutators, compiled in with -DI2P2_LATENCY. Without it
+   I2P2_LATENCY_SCOPE(op) expands to nothing. Each thread records into its own histograms with plain
+   relaxed stores, so recording takes no lock; latency_summary() merges every thread's histograms,
+   including those of threads that have exited. */
+#ifdef I2P2_LATENCY
+#define I2P2_LATENCY_SCOPE(op) I2P2::latency_timer i2p2_latency_timer(op)
+#else
+#define I2P2_LATENCY_SCOPE(op)
+#endif
+
+namespace I2P2
+{
+  enum latency_op
+  {
+    latency_push_back,
+    latency_push_front,
+    latency_pop_back,
+    latency_pop_front,
+    latency_insert,
+    latency_erase,
+    latency_reserve,
+    latency_clear,
+    latency_copy,       // copy constructor and copy assignment
+    latency_op_cnt
+  };
+  extern const char *const latency_op_names[latency_op_cnt];
+
+  /* Log-linear buckets in the style of HdrHistogram: values below 16 ns are exact, larger ones fall
+     in one of 16 buckets per power of two, so every reported value is within 1/16 of a recorded one. */
+  class latency_histogram
+  {
+    public:
+      static const int sub_bucket_bits = 4;
+      static const int sub_bucket_cnt = 1 << sub_bucket_bits;
+      static const int bucket_cnt = (64 - sub_bucket_bits + 1) * sub_bucket_cnt;
+
+      static int bucket_of(uint64_t ns);
+      // the largest value that falls in the bucket
+      static uint64_t bucket_top(int bucket);
+
+      latency_histogram();
+      void record(uint64_t ns);
+      // for building a histogram from raw bucket counts
+      void add(int bucket, uint64_t count);
+      void raise_max(uint64_t ns);
+      void merge(const latency_histogram &rhs);
+      uint64_t count() const { return _count; }
+      uint64_t max() const { return _max; }
+      // the value at or below which a fraction q (0..1) of the samples lie, 0 when empty
+      uint64_t percentile(double q) const;
+
+    private:
+      uint64_t _counts[bucket_cnt];
+      uint64_t _count;
+      uint64_t _max;
+  };
+
+  struct latency_report
+  {
+    uint64_t count;
+    uint64_t p50, p99, p999, max;   // ns
+  };
+
+  void record_latency(latency_op op, uint64_t ns);
+  // every thread's samples for op, merged
+  latency_histogram latency_snapshot(latency_op op);
+  latency_report latency_summary(latency_op op);
+  // samples recorded concurrently with a reset may survive it
+  void reset_latency();
+  // one "op count p50 p99 p999 max" line per operation that has samples
+  void print_latency(FILE *out = stdout);
+
+  /* Times one public operation. Operations built on others (push_front on insert, push_back growing
+     through reserve, a List copy pushing every element) open nested timers; only the outermost one
+     records, so each histogram measures calls to its own operation. */
+  class latency_timer
+  {
+    private:
+      latency_op _op;
+      bool _outermost;
+      std::chrono::steady_clock::time_point _start;
+
+      static unsigned &depth()
+      {
+        static thread_local unsigned open_timers = 0;
+        return open_timers;
+      }
+
+    public:
+      explicit latency_timer(latency_op op) : _op(op), _outermost(depth()++ == 0)
+      {
+        if (_outermost)
+          _start = std::chrono::steady_clock::now();
+      }
+      ~latency_timer()
+      {
+        depth()--;
+        if (_outermost)
+          record_latency(_op, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+      }
+      latency_timer(const latency_timer &rhs) = delete;
+      latency_timer &operator=(const latency_timer &rhs) = delete;
+  };
+}  // namespace I2P2
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef I2P2_STATIC_CONTAINER_H
+#define I2P2_STATIC_CONTAINER_H
+#include "I2P2_def.h"
+#include "I2P2_iterator.h"
+#include "I2P2_container.h"
+
+#if __cplusplus >= 202002L
+#define I2P2_CONSTEXPR20 constexpr
+#else
+#define I2P2_CONSTEXPR20
+#endif
+
+namespace I2P2 {
+/* Compile-time mirror of the hierarchy in I2P2_container.h. A container derives from
+   static_xxx_container<Self> and gets no vtable; every call is resolved statically and can be
+   inlined. The bases only fill in the members that follow from others (capacity from size,
+   front from operator[], ...), and a container hides any of them by declaring its own.
+   Generic code takes the container type as a template parameter. Code that needs runtime
+   polymorphism wraps one in ordered_adapter/randomaccess_adapter below. */
+template <class Derived>
+struct static_container_base {
+  I2P2_CONSTEXPR20 Derived &self() { return static_cast<Derived &>(*this); }
+  I2P2_CONSTEXPR20 const Derived &self() const { return static_cast<const Derived &>(*this); }
+  I2P2_CONSTEXPR20 bool empty() const { return self().size() == 0; }
+};
+
+template <class Derived>
+struct static_dynamic_size_container : static_container_base<Derived> {
+  void reserve(size_type new_capacity) {}
+  void shrink_to_fit() {}
+  I2P2_CONSTEXPR20 size_type capacity() const { return this->self().size(); }
+};
+
+template <class Derived>
+struct static_ordered_container : static_dynamic_size_container<Derived> {
+  void pop_front() { this->self().erase(this->self().begin()); }
+  void push_front(const_reference val) { this->self().insert(this->self().begin(), 1, val); }
+};
+
+template <class Derived>
+struct static_randomaccess_container : static_ordered_container<Derived> {
+  I2P2_CONSTEXPR20 reference front() { return this->self()[0]; }
+  I2P2_CONSTEXPR20 const_reference front() const { return this->self()[0]; }
+  I2P2_CONSTEXPR20 reference back() { return this->self()[this->self().size() - 1]; }
+  I2P2_CONSTEXPR20 const_reference back() const { return this->self()[this->self().size() - 1]; }
+};
+
+/* Thin adapters from a statically dispatched container to the virtual interface. */
+template <class Container, class Interface = ordered_container>
+class ordered_adapter : public Interface {
+ protected:
+  Container _con;
+
+ public:
+  ordered_adapter() {}
+  explicit ordered_adapter(const Container &con) : _con(con) {}
+  Container &get() { return _con; }
+  const Container &get() const { return _con; }
+
+  bool empty() const { return _con.empty(); }
+  size_type size() const { return _con.size(); }
+  iterator begin() { return _con.begin(); }
+  const_iterator begin() const { return _con.begin(); }
+  iterator end() { return _con.end(); }
+  const_iterator end() const { return _con.end(); }
+  void clear() { _con.clear(); }
+  void erase(const_iterator pos) { _con.erase(pos); }
+  void erase(const_iterator begin, const_iterator end) { _con.erase(begin, end); }
+  void reserve(size_type new_capacity) { _con.reserve(new_capacity); }
+  void shrink_to_fit() { _con.shrink_to_fit(); }
+  size_type capacity() const { return _con.capacity(); }
+  reference back() { return _con.back(); }
+  const_reference back() const { return _con.back(); }
+  reference front() { return _con.front(); }
+  const_reference front() const { return _con.front(); }
+  void insert(const_iterator pos, size_type count, const_reference val) { _con.insert(pos, count, val); }
+  void insert(const_iterator pos, const_iterator begin, const_iterator end) { _con.insert(pos, begin, end); }
+  void pop_back() { _con.pop_back(); }
+  void pop_front() { _con.pop_front(); }
+  void push_back(const_reference val) { _con.push_back(val); }
+  void push_front(const_reference val) { _con.push_front(val); }
+};
+
+template <class Container>
+class randomaccess_adapter : public ordered_adapter<Container, randomaccess_container> {
+ public:
+  randomaccess_adapter() {}
+  explicit randomaccess_adapter(const Container &con) : ordered_adapter<Container, randomaccess_container>(con) {}
+
+  reference operator[](size_type pos) { return this->_con[pos]; }
+  const_reference operator[](size_type pos) const { return this->_con[pos]; }
+};
+}  // namespace I2P2
+
+#endif
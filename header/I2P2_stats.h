@@ -0,0 +1,55 @@
+#ifndef I2P2_STATS_H
+#define I2P2_STATS_H
+#include <cstdio>
+#include <cstdint>
+#include "I2P2_def.h"
+
+/* Allocation statistics, compiled in with -DI2P2_STATS. Without it I2P2_STAT(...) expands to
+   nothing and containers carry no extra members, so the default build pays nothing.
+   Each instrumented container keeps its own counters (stats()); every update also goes to
+   process-wide atomic counters (global_stats()), which alone see iterator clones. */
+#ifdef I2P2_STATS
+#define I2P2_STAT(expr) expr
+#else
+#define I2P2_STAT(expr)
+#endif
+
+namespace I2P2
+{
+  struct alloc_stats
+  {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_freed = 0;
+    uint64_t reallocations = 0;     // buffers replaced while holding elements
+    uint64_t elements_moved = 0;    // relocated by reserve/shrink or shifted by insert/erase
+    uint64_t elements_copied = 0;   // written from a source by copy, assign, insert, append
+    uint64_t peak_capacity = 0;     // in elements; globally the largest of any container
+    uint64_t iterator_clones = 0;   // iterator_impl_base::clone() calls, global only
+  };
+
+  /* One call per event; each updates the given container's counters and the global ones. */
+  void count_allocation(alloc_stats &stats, size_type bytes);
+  void count_free(alloc_stats &stats, size_type bytes);
+  void count_reallocation(alloc_stats &stats);
+  void count_moved(alloc_stats &stats, size_type count);
+  void count_copied(alloc_stats &stats, size_type count);
+  void count_capacity(alloc_stats &stats, size_type capacity);
+  void count_iterator_clone();
+  /* A live allocation changing owner (a List node spliced into another list): it leaves from's
+     counters and joins to's, so each container's allocations and frees still balance. The global
+     counters are unchanged. */
+  void count_handover(alloc_stats &from, alloc_stats &to, size_type bytes);
+
+  alloc_stats global_stats();
+  void reset_global_stats();
+
+  /* Dump for exporters: emit(name, value, ctx) once per counter, named "<prefix>.<counter>". */
+  typedef void (*stats_emitter)(const char *name, uint64_t value, void *ctx);
+  void dump_stats(const alloc_stats &stats, const char *prefix, stats_emitter emit, void *ctx);
+  // dump_stats() as "name value" lines
+  void print_stats(const alloc_stats &stats, const char *prefix, FILE *out = stdout);
+}  // namespace I2P2
+
+#endif
@@ -2,6 +2,11 @@
 #define I2P2_TEST_H
 
 namespace I2P2_test {
+  // reseeds the main thread's generator so a run can be reproduced
+  void seed(unsigned long long value);
+  /* Runs every compiled-in differential test in `workers` threads (0: one per core), worker i
+     seeded with seed + i. Returns the number of failing workers; each is reported with its seed. */
+  int fuzz(unsigned workers, unsigned long long seed);
   void check_hierarchy();
   void check_iterator();
 #ifdef TEST_LIST
@@ -10,6 +15,69 @@ namespace I2P2_test {
 #ifdef TEST_VECTOR
   void check_vector();
 #endif
+#ifdef TEST_COW_VECTOR
+  void check_cow_vector();
+#endif
+#ifdef TEST_PERSISTENT_VECTOR
+  void check_persistent_vector();
+#endif
+#ifdef TEST_ROPE
+  void check_rope();
+#endif
+#ifdef TEST_GAP_BUFFER
+  void check_gap_buffer();
+#endif
+#ifdef TEST_SEGMENTED_VECTOR
+  void check_segmented_vector();
+#endif
+#ifdef TEST_STATIC_VECTOR
+  void check_static_vector();
+#endif
+#ifdef TEST_FLAT_SET
+  void check_flat_set();
+#endif
+#ifdef TEST_FLAT_MAP
+  void check_flat_map();
+#endif
+#ifdef TEST_EYTZINGER_INDEX
+  void check_eytzinger_index();
+#endif
+#ifdef TEST_HASH_SET
+  void check_hash_set();
+#endif
+#ifdef TEST_HASH_MAP
+  void check_hash_map();
+#endif
+#ifdef TEST_LRU_CACHE
+  void check_lru_cache();
+#endif
+#ifdef TEST_PRIORITY_QUEUE
+  void check_priority_queue();
+#endif
+#ifdef TEST_SLOT_MAP
+  void check_slot_map();
+#endif
+#ifdef TEST_PACKED_VECTOR
+  void check_packed_vector();
+#endif
+#ifdef TEST_SPAN
+  void check_span();
+#endif
+#ifdef TEST_TRACE
+  void check_trace();
+#endif
+#ifdef TEST_STATS
+  void check_stats();
+#endif
+#ifdef TEST_LATENCY
+  void check_latency();
+#endif
+#ifdef TEST_SPSC_QUEUE
+  void check_spsc_queue();
+#endif
+#ifdef TEST_CONCURRENT_LIST
+  void check_concurrent_list();
+#endif
 }
 
 #endif
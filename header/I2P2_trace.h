@@ -0,0 +1,117 @@
+#ifndef I2P2_TRACE_H
+#define I2P2_TRACE_H
+#include <cstdio>
+#include <cstdint>
+#include "I2P2_def.h"
+
+namespace I2P2
+{
+  /* Operation traces: a binary file of fixed-size records, one per container operation, behind an
+     8-byte magic and the sizeof(value_type) it was written with. Positions are indexes, so one
+     trace replays against any ordered container. Traces come from generate_trace() or from a live
+     program through traced<C>, and bench/I2P2_replay.cpp plays them back. */
+  enum trace_op : uint8_t
+  {
+    trace_push_back,
+    trace_push_front,
+    trace_pop_back,
+    trace_pop_front,
+    trace_insert,       // count copies of val before pos
+    trace_erase,        // the element at pos
+    trace_erase_range,  // count elements from pos
+    trace_clear,
+    trace_read,         // operator[] / advance to pos and read
+    trace_write,        // store val at pos
+    trace_iterate,      // visit every element
+    trace_copy,         // copy-construct the container
+    trace_op_cnt
+  };
+  extern const char *const trace_op_names[trace_op_cnt];
+
+  struct trace_record
+  {
+    trace_op op;
+    uint64_t pos;
+    uint64_t count;
+    value_type val;
+  };
+
+  class trace_writer
+  {
+    private:
+      FILE *file;
+
+    public:
+      explicit trace_writer(const char *path);
+      ~trace_writer();
+      trace_writer(const trace_writer &rhs) = delete;
+      trace_writer &operator=(const trace_writer &rhs) = delete;
+      // false once opening or any write has failed; later writes are dropped
+      bool ok() const;
+      void write(trace_op op, uint64_t pos = 0, uint64_t count = 0, value_type val = 0);
+      // pushes buffered records to the file, so ok() also covers them; returns ok()
+      bool flush();
+  };
+
+  class trace_reader
+  {
+    private:
+      FILE *file;
+
+    public:
+      // fails (ok() == false) on a missing file, a bad magic or a different value_type size
+      explicit trace_reader(const char *path);
+      ~trace_reader();
+      trace_reader(const trace_reader &rhs) = delete;
+      trace_reader &operator=(const trace_reader &rhs) = delete;
+      bool ok() const;
+      bool next(trace_record &rec);
+  };
+
+  // a random mix shaped like the fuzzer's, reproducible from the seed
+  void generate_trace(trace_writer &out, uint64_t seed, size_type count);
+
+  /* Recording hook: forwards to a container and logs each call. Use it in place of the container
+     in the code whose operation mix should be captured. */
+  template <class Container>
+  class traced
+  {
+    private:
+      Container &_con;
+      trace_writer &_out;
+
+    public:
+      traced(Container &con, trace_writer &out) : _con(con), _out(out) {}
+      Container &get() { return _con; }
+      size_type size() const { return _con.size(); }
+      bool empty() const { return _con.empty(); }
+      void push_back(const_reference val) { _out.write(trace_push_back, 0, 0, val); _con.push_back(val); }
+      void push_front(const_reference val) { _out.write(trace_push_front, 0, 0, val); _con.push_front(val); }
+      void pop_back() { _out.write(trace_pop_back); _con.pop_back(); }
+      void pop_front() { _out.write(trace_pop_front); _con.pop_front(); }
+      void insert(size_type pos, size_type count, const_reference val)
+      {
+        _out.write(trace_insert, pos, count, val);
+        _con.insert(_con.begin() + pos, count, val);
+      }
+      void erase(size_type pos) { _out.write(trace_erase, pos); _con.erase(_con.begin() + pos); }
+      void erase(size_type pos, size_type count)
+      {
+        _out.write(trace_erase_range, pos, count);
+        _con.erase(_con.begin() + pos, _con.begin() + (pos + count));
+      }
+      void clear() { _out.write(trace_clear); _con.clear(); }
+      value_type read(size_type pos) { _out.write(trace_read, pos); return *(_con.begin() + pos); }
+      void write(size_type pos, const_reference val) { _out.write(trace_write, pos, 0, val); *(_con.begin() + pos) = val; }
+      template <class Func>
+      void for_each(Func func)
+      {
+        _out.write(trace_iterate);
+        for (auto it = _con.begin(); it != _con.end(); ++it)
+          func(*it);
+      }
+      Container copy() const { _out.write(trace_copy); return _con; }
+  };
+}  // namespace I2P2
+
+#endif
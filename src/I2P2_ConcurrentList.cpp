@@ -0,0 +1,337 @@
+#include "../header/I2P2_ConcurrentList.h"
+
+namespace I2P2
+{
+  //pin implementation
+  ConcurrentList::pin::pin(const ConcurrentList &list) : _list(&list)
+  {
+    _slot = _list->enter();
+  }
+  ConcurrentList::pin::~pin()
+  {
+    _list->leave(_slot);
+  }
+
+  //cursor implementation
+  ConcurrentList::cursor::cursor(const ConcurrentList &list) : _pin(list), _list(&list)
+  {
+    _node = _list->head->next.load(std::memory_order_acquire);
+    skip_marked();
+  }
+  void ConcurrentList::cursor::skip_marked()
+  {
+    while (_node != _list->tail && _node->marked.load(std::memory_order_acquire))
+      _node = _node->next.load(std::memory_order_acquire);
+  }
+  bool ConcurrentList::cursor::valid() const
+  {
+    return _node != _list->tail;
+  }
+  void ConcurrentList::cursor::advance()
+  {
+    _node = _node->next.load(std::memory_order_acquire);
+    skip_marked();
+  }
+  value_type ConcurrentList::cursor::value() const
+  {
+    return _node->data;
+  }
+  ConcurrentList::handle ConcurrentList::cursor::get() const
+  {
+    return _node;
+  }
+
+  //ConcurrentList implementation
+  ConcurrentList::~ConcurrentList()
+  {
+    handle now = head;
+    while (now != nullptr)
+    {
+      handle temp = now;
+      now = now->next.load(std::memory_order_relaxed);
+      delete temp;
+    }
+
+    for (handle bucket : retired)
+      while (bucket != nullptr)
+      {
+        handle temp = bucket;
+        bucket = bucket->retired_next;
+        delete temp;
+      }
+
+    EpochSlot* slot = slots.load(std::memory_order_relaxed);
+    while (slot != nullptr)
+    {
+      EpochSlot* temp = slot;
+      slot = slot->next;
+      delete temp;
+    }
+  }
+  ConcurrentList::ConcurrentList() : _size(0), epoch(1), slots(nullptr), retired{}, retired_epoch{}, retired_cnt(0)
+  {
+    head = new ConcurrentNode(0);
+    tail = new ConcurrentNode(0);
+    head->next.store(tail, std::memory_order_relaxed);
+    tail->prev.store(head, std::memory_order_relaxed);
+  }
+  EpochSlot* ConcurrentList::enter() const
+  {
+    // reuse a slot a finished pin gave back, or add one; slots are never unlinked before destruction
+    EpochSlot* slot = slots.load();
+    while (slot != nullptr && (slot->claimed.load(std::memory_order_relaxed) || slot->claimed.exchange(true)))
+      slot = slot->next;
+    if (slot == nullptr)
+    {
+      slot = new EpochSlot;
+      slot->next = slots.load();
+      while (!slots.compare_exchange_weak(slot->next, slot))
+        ;
+    }
+
+    // announce the epoch, then make sure it is still current, so an advance cannot slip in between
+    // reading the epoch and announcing it
+    uint64_t now = epoch.load();
+    slot->epoch.store(now);
+    while (epoch.load() != now)
+    {
+      now = epoch.load();
+      slot->epoch.store(now);
+    }
+    return slot;
+  }
+  void ConcurrentList::leave(EpochSlot* slot) const
+  {
+    slot->epoch.store(0);
+    slot->claimed.store(false, std::memory_order_release);
+    if (retired_cnt.load(std::memory_order_relaxed) != 0)
+    {
+      try_advance();
+      reclaim();
+    }
+  }
+  void ConcurrentList::retire(handle node)
+  {
+    handle expired = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(retired_lock);
+      // the caller is pinned, so the epoch cannot move two past the value read here before the
+      // node is in its bucket; a bucket still tagged three epochs back only holds freeable nodes
+      uint64_t now = epoch.load();
+      int bucket = static_cast<int>(now % 3);
+      if (retired_epoch[bucket] != now)
+      {
+        expired = retired[bucket];
+        retired[bucket] = nullptr;
+        retired_epoch[bucket] = now;
+      }
+      node->retired_next = retired[bucket];
+      retired[bucket] = node;
+    }
+    retired_cnt.fetch_add(1, std::memory_order_relaxed);
+
+    while (expired != nullptr)
+    {
+      handle temp = expired;
+      expired = expired->retired_next;
+      delete temp;
+      retired_cnt.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+  void ConcurrentList::try_advance() const
+  {
+    uint64_t now = epoch.load();
+    for (EpochSlot* slot = slots.load(); slot != nullptr; slot = slot->next)
+    {
+      uint64_t seen = slot->epoch.load();
+      if (seen != 0 && seen != now)
+        return;
+    }
+    epoch.compare_exchange_strong(now, now + 1);
+  }
+  void ConcurrentList::reclaim() const
+  {
+    handle batch = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(retired_lock);
+      uint64_t now = epoch.load();
+      for (int bucket = 0; bucket != 3; bucket++)
+        if (retired[bucket] != nullptr && retired_epoch[bucket] + 2 <= now)
+        {
+          // every pin that could have reached these nodes entered no later than their epoch, and
+          // the epoch has since advanced past every one of them
+          handle last = retired[bucket];
+          while (last->retired_next != nullptr)
+            last = last->retired_next;
+          last->retired_next = batch;
+          batch = retired[bucket];
+          retired[bucket] = nullptr;
+        }
+    }
+
+    while (batch != nullptr)
+    {
+      handle temp = batch;
+      batch = batch->retired_next;
+      delete temp;
+      retired_cnt.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+  ConcurrentList::handle ConcurrentList::link_after(handle pos, const_reference val)
+  {
+    if (pos == tail)
+      return nullptr;
+
+    std::lock_guard<std::mutex> lock_pred(pos->lock);
+    if (pos->marked.load())
+      return nullptr;
+
+    // succ cannot be unlinked while we hold its predecessor's lock
+    handle succ = pos->next.load();
+    std::lock_guard<std::mutex> lock_succ(succ->lock);
+
+    handle newnode = new ConcurrentNode(val);
+    newnode->prev.store(pos, std::memory_order_relaxed);
+    newnode->next.store(succ, std::memory_order_relaxed);
+    pos->next.store(newnode, std::memory_order_release);
+    succ->prev.store(newnode, std::memory_order_release);
+
+    _size++;
+    return newnode;
+  }
+  ConcurrentList::handle ConcurrentList::link_before(handle pos, const_reference val)
+  {
+    if (pos == head)
+      return nullptr;
+
+    while (true)
+    {
+      if (pos->marked.load())
+        return nullptr;
+
+      handle pred = pos->prev.load();
+      std::lock_guard<std::mutex> lock_pred(pred->lock);
+      std::lock_guard<std::mutex> lock_pos(pos->lock);
+
+      if (pos->marked.load())
+        return nullptr;
+      if (pred->marked.load() || pred->next.load() != pos)
+        continue;
+
+      handle newnode = new ConcurrentNode(val);
+      newnode->prev.store(pred, std::memory_order_relaxed);
+      newnode->next.store(pos, std::memory_order_relaxed);
+      pred->next.store(newnode, std::memory_order_release);
+      pos->prev.store(newnode, std::memory_order_release);
+
+      _size++;
+      return newnode;
+    }
+  }
+  bool ConcurrentList::unlink(handle node)
+  {
+    if (node == head || node == tail)
+      return false;
+
+    while (true)
+    {
+      if (node->marked.load())
+        return false;
+
+      {
+        handle pred = node->prev.load();
+        std::lock_guard<std::mutex> lock_pred(pred->lock);
+        std::lock_guard<std::mutex> lock_node(node->lock);
+
+        if (node->marked.load())
+          return false;
+        if (pred->marked.load() || pred->next.load() != node)
+          continue;
+
+        handle succ = node->next.load();
+        std::lock_guard<std::mutex> lock_succ(succ->lock);
+
+        node->marked.store(true);
+        pred->next.store(succ, std::memory_order_release);
+        succ->prev.store(pred, std::memory_order_release);
+        _size--;
+      }
+
+      retire(node);
+      return true;
+    }
+  }
+  size_type ConcurrentList::size() const
+  {
+    return _size.load();
+  }
+  bool ConcurrentList::empty() const
+  {
+    return size() == 0;
+  }
+  size_type ConcurrentList::retired_count() const
+  {
+    return retired_cnt.load();
+  }
+  ConcurrentList::handle ConcurrentList::push_back(const_reference val)
+  {
+    pin guard(*this);
+    return link_before(tail, val);
+  }
+  ConcurrentList::handle ConcurrentList::push_front(const_reference val)
+  {
+    pin guard(*this);
+    return link_after(head, val);
+  }
+  ConcurrentList::handle ConcurrentList::insert_after(handle pos, const_reference val)
+  {
+    pin guard(*this);
+    return link_after(pos, val);
+  }
+  ConcurrentList::handle ConcurrentList::insert_before(handle pos, const_reference val)
+  {
+    pin guard(*this);
+    return link_before(pos, val);
+  }
+  bool ConcurrentList::erase(handle pos)
+  {
+    pin guard(*this);
+    return unlink(pos);
+  }
+  bool ConcurrentList::pop_back(reference val)
+  {
+    pin guard(*this);
+    while (true)
+    {
+      handle now = tail->prev.load();
+      if (now == head)
+        return false;
+      if (unlink(now))
+      {
+        val = now->data;
+        return true;
+      }
+    }
+  }
+  bool ConcurrentList::pop_front(reference val)
+  {
+    pin guard(*this);
+    while (true)
+    {
+      handle now = head->next.load();
+      if (now == tail)
+        return false;
+      if (unlink(now))
+      {
+        val = now->data;
+        return true;
+      }
+    }
+  }
+  void ConcurrentList::clear()
+  {
+    value_type val;
+    while (pop_front(val))
+      ;
+  }
+}  // namespace I2P2
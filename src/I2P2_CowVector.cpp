@@ -0,0 +1,223 @@
+#include "../header/I2P2_CowVector.h"
+
+namespace I2P2
+{
+  namespace
+  {
+    const_iterator begin_of(const CowVector &vec)
+    {
+      return vec.begin();
+    }
+    const_iterator end_of(const CowVector &vec)
+    {
+      return vec.end();
+    }
+  }
+
+  CowVector::~CowVector()
+  {
+    release();
+  }
+  CowVector::CowVector()
+  {
+    _rep = new rep();
+  }
+  CowVector::CowVector(const CowVector &rhs)
+  {
+    _rep = rhs.share();
+  }
+  CowVector& CowVector::operator=(const CowVector &rhs)
+  {
+    if (this == &rhs || _rep == rhs._rep)
+      return *this;
+
+    rep* new_rep = rhs.share();
+    release();
+    _rep = new_rep;
+    return *this;
+  }
+  void CowVector::release()
+  {
+    if (_rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete _rep;
+  }
+  void CowVector::detach()
+  {
+    if (_rep->refs.load(std::memory_order_acquire) == 1)
+      return;
+
+    rep* new_rep = new rep(_rep->vec);
+    release();
+    _rep = new_rep;
+  }
+  CowVector::rep* CowVector::share() const
+  {
+    if (!_rep->shareable)
+      return new rep(_rep->vec);
+
+    _rep->refs.fetch_add(1, std::memory_order_relaxed);
+    return _rep;
+  }
+  const_pointer CowVector::data_ref() const
+  {
+    const Vector &vec = _rep->vec;
+    return vec.empty() ? nullptr : &vec[0];
+  }
+  bool CowVector::shared() const
+  {
+    return _rep->refs.load(std::memory_order_acquire) > 1;
+  }
+  iterator CowVector::begin()
+  {
+    detach();
+    _rep->shareable = false;
+    return _rep->vec.begin();
+  }
+  const_iterator CowVector::begin() const
+  {
+    const Vector &vec = _rep->vec;
+    return vec.begin();
+  }
+  iterator CowVector::end()
+  {
+    detach();
+    _rep->shareable = false;
+    return _rep->vec.end();
+  }
+  const_iterator CowVector::end() const
+  {
+    const Vector &vec = _rep->vec;
+    return vec.end();
+  }
+  reference CowVector::front()
+  {
+    detach();
+    _rep->shareable = false;
+    return _rep->vec.front();
+  }
+  const_reference CowVector::front() const
+  {
+    const Vector &vec = _rep->vec;
+    return vec.front();
+  }
+  reference CowVector::back()
+  {
+    detach();
+    _rep->shareable = false;
+    return _rep->vec.back();
+  }
+  const_reference CowVector::back() const
+  {
+    const Vector &vec = _rep->vec;
+    return vec.back();
+  }
+  reference CowVector::operator[](size_type pos)
+  {
+    detach();
+    _rep->shareable = false;
+    return _rep->vec[pos];
+  }
+  const_reference CowVector::operator[](size_type pos) const
+  {
+    const Vector &vec = _rep->vec;
+    return vec[pos];
+  }
+  size_type CowVector::capacity() const
+  {
+    return _rep->vec.capacity();
+  }
+  size_type CowVector::size() const
+  {
+    return _rep->vec.size();
+  }
+  void CowVector::clear()
+  {
+    if (shared())
+    {
+      release();
+      _rep = new rep();
+      return;
+    }
+
+    _rep->vec.clear();
+    _rep->shareable = true;
+  }
+  bool CowVector::empty() const
+  {
+    return _rep->vec.empty();
+  }
+  /* Positions are turned into indices before detaching, because the caller's iterators may
+     point into the shared buffer rather than into our private clone. */
+  void CowVector::erase(const_iterator pos)
+  {
+    size_type position = pos - begin_of(*this);
+    detach();
+    const_pointer old_data = data_ref();
+    _rep->vec.erase(_rep->vec.begin() + position);
+    if (data_ref() != old_data)
+      _rep->shareable = true;
+  }
+  void CowVector::erase(const_iterator begin, const_iterator end)
+  {
+    size_type start = begin - begin_of(*this);
+    size_type fin = end - begin_of(*this);
+    detach();
+    const_pointer old_data = data_ref();
+    _rep->vec.erase(_rep->vec.begin() + start, _rep->vec.begin() + fin);
+    if (data_ref() != old_data)
+      _rep->shareable = true;
+  }
+  void CowVector::insert(const_iterator pos, size_type count, const_reference val)
+  {
+    size_type position = pos - begin_of(*this);
+    value_type copy = val;
+    detach();
+    const_pointer old_data = data_ref();
+    _rep->vec.insert(_rep->vec.begin() + position, count, copy);
+    if (data_ref() != old_data)
+      _rep->shareable = true;
+  }
+  void CowVector::insert(const_iterator pos, const_iterator begin, const_iterator end)
+  {
+    size_type position = pos - begin_of(*this);
+    detach();
+    const_pointer old_data = data_ref();
+    _rep->vec.insert(_rep->vec.begin() + position, begin, end);
+    if (data_ref() != old_data)
+      _rep->shareable = true;
+  }
+  void CowVector::pop_back()
+  {
+    erase(begin_of(*this) + (size() - 1));
+  }
+  void CowVector::pop_front()
+  {
+    erase(begin_of(*this));
+  }
+  void CowVector::push_back(const_reference val)
+  {
+    insert(end_of(*this), 1, val);
+  }
+  void CowVector::push_front(const_reference val)
+  {
+    insert(begin_of(*this), 1, val);
+  }
+  void CowVector::reserve(size_type new_capacity)
+  {
+    if (new_capacity <= capacity())
+      return;
+
+    detach();
+    _rep->vec.reserve(new_capacity);
+    _rep->shareable = true;
+  }
+  void CowVector::shrink_to_fit()
+  {
+    if (capacity() == size())
+      return;
+
+    detach();
+    _rep->vec.shrink_to_fit();
+    _rep->shareable = true;
+  }
+}  // namespace I2P2
@@ -0,0 +1,109 @@
+#include "../header/I2P2_EytzingerIndex.h"
+#include <cstdint>
+
+namespace I2P2
+{
+  namespace
+  {
+    // elements per 64-byte cache line: the descendants this many slots down share one line
+    const size_type line_elements = 64 / sizeof(value_type) ? 64 / sizeof(value_type) : 1;
+    // batch width of lower_bound_many, about as many misses as a core keeps in flight
+    const size_type group_size = 16;
+
+    inline void prefetch_descendants(const_pointer tree, size_type k)
+    {
+      // may point past the end; a prefetch never faults
+      __builtin_prefetch(reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(tree) + k * line_elements * sizeof(value_type)));
+    }
+    // undoes the trailing right turns taken after the last left turn: the slot of the answer, 0 if none
+    inline size_type answer_slot(size_type k)
+    {
+      return k >> __builtin_ffsll(~static_cast<unsigned long long>(k));
+    }
+  }
+
+  EytzingerIndex::EytzingerIndex() : _size(0), _depth(0)
+  {
+    build(VectorView());
+  }
+  EytzingerIndex::EytzingerIndex(VectorView sorted) : _size(0), _depth(0)
+  {
+    build(sorted);
+  }
+  void EytzingerIndex::build(VectorView sorted)
+  {
+    _size = sorted.size();
+    _tree.resize_uninitialized(0);
+    _tree.resize_uninitialized(_size + 1);
+    _tree[0] = value_type();
+    // slot 0 stands for "past the end"
+    _rank.assign(_size + 1, _size);
+    fill(sorted, 0, 1);
+
+    _depth = 0;
+    while ((size_type(2) << _depth) - 1 <= _size)
+      _depth++;
+  }
+  // in-order walk of the implicit tree hands out the sorted elements in order
+  size_type EytzingerIndex::fill(VectorView sorted, size_type i, size_type k)
+  {
+    if (k > _size)
+      return i;
+
+    i = fill(sorted, i, 2 * k);
+    _tree[k] = sorted[i];
+    _rank[k] = i;
+    return fill(sorted, i + 1, 2 * k + 1);
+  }
+
+  size_type EytzingerIndex::search(value_type key) const
+  {
+    const_pointer tree = _tree.data();
+    size_type k = 1;
+    while (k <= _size)
+    {
+      prefetch_descendants(tree, k);
+      k = 2 * k + (tree[k] < key);
+    }
+    return answer_slot(k);
+  }
+  size_type EytzingerIndex::lower_bound(value_type key) const
+  {
+    return _rank[search(key)];
+  }
+  size_type EytzingerIndex::find(value_type key) const
+  {
+    size_type k = search(key);
+    return k != 0 && !(key < _tree[k]) ? _rank[k] : _size;
+  }
+  void EytzingerIndex::lower_bound_many(VectorView keys, size_type *out) const
+  {
+    const_pointer tree = _tree.data();
+    size_type slots[group_size];
+    for (size_type first = 0; first < keys.size(); first += group_size)
+    {
+      size_type count = keys.size() - first < group_size ? keys.size() - first : group_size;
+      const_pointer key = keys.data() + first;
+      for (size_type g = 0; g < count; g++)
+        slots[g] = 1;
+
+      // every search takes _depth steps through the complete levels, so the group stays in lockstep
+      for (int level = 0; level < _depth; level++)
+      {
+        for (size_type g = 0; g < count; g++)
+        {
+          prefetch_descendants(tree, slots[g]);
+          slots[g] = 2 * slots[g] + (tree[slots[g]] < key[g]);
+        }
+      }
+      // and at most one more into the partial last level
+      for (size_type g = 0; g < count; g++)
+      {
+        size_type k = slots[g];
+        if (k <= _size)
+          k = 2 * k + (tree[k] < key[g]);
+        out[first + g] = _rank[answer_slot(k)];
+      }
+    }
+  }
+}  // namespace I2P2
@@ -0,0 +1,147 @@
+#include "../header/I2P2_FlatMap.h"
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+
+namespace I2P2
+{
+  FlatMap::FlatMap() {}
+  size_type FlatMap::find(const_reference key) const
+  {
+    size_type pos = lower_bound(key);
+    return pos != size() && !(key < _keys[pos]) ? pos : size();
+  }
+  reference FlatMap::at(const_reference key)
+  {
+    size_type pos = find(key);
+    if (pos == size())
+      throw std::out_of_range("FlatMap::at: key not found");
+    return _values[pos];
+  }
+  const_reference FlatMap::at(const_reference key) const
+  {
+    size_type pos = find(key);
+    if (pos == size())
+      throw std::out_of_range("FlatMap::at: key not found");
+    return _values[pos];
+  }
+  reference FlatMap::operator[](const_reference key)
+  {
+    size_type pos = lower_bound(key);
+    if (pos == size() || key < _keys[pos])
+    {
+      value_type copy = key;
+      _keys.insert(_keys.begin() + pos, 1, copy);
+      _values.insert(_values.begin() + pos, 1, value_type());
+    }
+    return _values[pos];
+  }
+  bool FlatMap::insert(const_reference key, const_reference val)
+  {
+    size_type pos = lower_bound(key);
+    if (pos != size() && !(key < _keys[pos]))
+      return false;
+
+    value_type key_copy = key, val_copy = val;
+    _keys.insert(_keys.begin() + pos, 1, key_copy);
+    _values.insert(_values.begin() + pos, 1, val_copy);
+    return true;
+  }
+  bool FlatMap::insert_or_assign(const_reference key, const_reference val)
+  {
+    size_type pos = lower_bound(key);
+    if (pos != size() && !(key < _keys[pos]))
+    {
+      _values[pos] = val;
+      return false;
+    }
+
+    value_type key_copy = key, val_copy = val;
+    _keys.insert(_keys.begin() + pos, 1, key_copy);
+    _values.insert(_values.begin() + pos, 1, val_copy);
+    return true;
+  }
+  size_type FlatMap::insert_many(VectorView keys, VectorView values)
+  {
+    size_type count = std::min(keys.size(), values.size());
+    if (count == 0)
+      return 0;
+
+    // stable, so the first of equal keys stays in front and unique keeps it
+    std::vector<std::pair<value_type, value_type>> batch(count);
+    for (size_type i = 0; i < count; i++)
+      batch[i] = std::make_pair(keys[i], values[i]);
+    auto key_less = [](const std::pair<value_type, value_type> &lhs, const std::pair<value_type, value_type> &rhs) {
+      return lhs.first < rhs.first;
+    };
+    std::stable_sort(batch.begin(), batch.end(), key_less);
+    batch.erase(std::unique(batch.begin(), batch.end(),
+                            [](const std::pair<value_type, value_type> &lhs, const std::pair<value_type, value_type> &rhs) {
+                              return !(lhs.first < rhs.first) && !(rhs.first < lhs.first);
+                            }),
+                batch.end());
+    size_type k = batch.size();
+
+    // merge from the back, the same way as FlatSet::insert_many, moving both arrays in step
+    size_type n = size();
+    _keys.resize_uninitialized(n + k);
+    _values.resize_uninitialized(n + k);
+    pointer key_out = _keys.data();
+    pointer val_out = _values.data();
+    size_type out = n + k;
+    size_type a = n;
+    size_type b = k;
+    while (b != 0)
+    {
+      if (a == 0 || key_out[a - 1] < batch[b - 1].first)
+      {
+        --out, --b;
+        key_out[out] = batch[b].first;
+        val_out[out] = batch[b].second;
+      }
+      else if (batch[b - 1].first < key_out[a - 1])
+      {
+        --out, --a;
+        key_out[out] = key_out[a];
+        val_out[out] = val_out[a];
+      }
+      else
+      {
+        // present already: keep the old pair, drop the batch's
+        --out, --a, --b;
+        key_out[out] = key_out[a];
+        val_out[out] = val_out[a];
+      }
+    }
+    size_type gap = out - a;
+    if (gap != 0)
+    {
+      std::copy(key_out + out, key_out + n + k, key_out + a);
+      std::copy(val_out + out, val_out + n + k, val_out + a);
+      _keys.resize(n + k - gap);
+      _values.resize(n + k - gap);
+    }
+    return k - gap;
+  }
+  bool FlatMap::erase(const_reference key)
+  {
+    size_type pos = find(key);
+    if (pos == size())
+      return false;
+
+    _keys.erase(_keys.begin() + pos);
+    _values.erase(_values.begin() + pos);
+    return true;
+  }
+  void FlatMap::reserve(size_type new_capacity)
+  {
+    _keys.reserve(new_capacity);
+    _values.reserve(new_capacity);
+  }
+  void FlatMap::clear()
+  {
+    _keys.clear();
+    _values.clear();
+  }
+}  // namespace I2P2
@@ -0,0 +1,85 @@
+#include "../header/I2P2_FlatSet.h"
+#include <cstring>
+
+namespace I2P2
+{
+  FlatSet::FlatSet() {}
+  FlatSet::FlatSet(VectorView src)
+  {
+    insert_many(src);
+  }
+  size_type FlatSet::upper_bound(const_reference key) const
+  {
+    size_type pos = lower_bound(key);
+    return pos != size() && !(key < _keys[pos]) ? pos + 1 : pos;
+  }
+  size_type FlatSet::find(const_reference key) const
+  {
+    size_type pos = lower_bound(key);
+    return pos != size() && !(key < _keys[pos]) ? pos : size();
+  }
+  bool FlatSet::insert(const_reference key)
+  {
+    size_type pos = lower_bound(key);
+    if (pos != size() && !(key < _keys[pos]))
+      return false;
+
+    _keys.insert(_keys.begin() + pos, 1, key);
+    return true;
+  }
+  size_type FlatSet::insert_many(VectorView batch)
+  {
+    if (batch.empty())
+      return 0;
+
+    // the batch may be a view of this set, so sort a copy
+    Vector sorted(batch);
+    pointer b_first = sorted.data();
+    std::sort(b_first, b_first + sorted.size());
+    pointer b_last = std::unique(b_first, b_first + sorted.size());
+    size_type k = b_last - b_first;
+
+    // merge from the back into [0, n + k); each key already present leaves one slot unused
+    size_type n = size();
+    _keys.resize_uninitialized(n + k);
+    pointer keys = _keys.data();
+    pointer out = keys + n + k;
+    pointer a = keys + n;
+    pointer b = b_last;
+    while (b != b_first)
+    {
+      if (a == keys)
+      {
+        size_type rest = b - b_first;
+        out -= rest;
+        std::memcpy(out, b_first, rest * sizeof(value_type));
+        break;
+      }
+      if (b[-1] < a[-1])
+        *--out = *--a;
+      else
+      {
+        if (!(a[-1] < b[-1]))
+          --a;
+        *--out = *--b;
+      }
+    }
+    // whatever is left of the old keys is already below out; close the gap
+    size_type gap = out - a;
+    if (gap != 0)
+    {
+      std::memmove(a, out, (keys + n + k - out) * sizeof(value_type));
+      _keys.resize(n + k - gap);
+    }
+    return k - gap;
+  }
+  bool FlatSet::erase(const_reference key)
+  {
+    size_type pos = find(key);
+    if (pos == size())
+      return false;
+
+    _keys.erase(_keys.begin() + pos);
+    return true;
+  }
+}  // namespace I2P2
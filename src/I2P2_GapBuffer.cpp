@@ -0,0 +1,273 @@
+#include "../header/I2P2_GapBuffer.h"
+#include "../header/I2P2_Vector.h"
+#include <algorithm>
+
+namespace I2P2
+{
+  GapBuffer::~GapBuffer()
+  {
+    if (p_begin != nullptr)
+      operator delete[](p_begin);
+  }
+  GapBuffer::GapBuffer()
+  {
+    p_begin = nullptr;
+    p_gap = nullptr;
+    p_gap_end = nullptr;
+    p_end = nullptr;
+  }
+  GapBuffer::GapBuffer(const GapBuffer &rhs)
+  {
+    p_begin = nullptr;
+    p_gap = nullptr;
+    p_gap_end = nullptr;
+    p_end = nullptr;
+
+    reallocate(rhs.size());
+    p_gap = std::copy(rhs.p_begin, rhs.p_gap, p_gap);
+    p_gap = std::copy(rhs.p_gap_end, rhs.p_end, p_gap);
+  }
+  GapBuffer& GapBuffer::operator=(const GapBuffer &rhs)
+  {
+    if (this == &rhs)
+      return *this;
+
+    clear();
+    if (capacity() < rhs.size())
+      reallocate(rhs.size());
+    p_gap = std::copy(rhs.p_begin, rhs.p_gap, p_gap);
+    p_gap = std::copy(rhs.p_gap_end, rhs.p_end, p_gap);
+    return *this;
+  }
+  void GapBuffer::move_gap(size_type pos)
+  {
+    size_type gap_pos = p_gap - p_begin;
+
+    if (pos < gap_pos)
+    {
+      size_type count = gap_pos - pos;
+      std::copy_backward(p_begin + pos, p_gap, p_gap_end);
+      p_gap -= count;
+      p_gap_end -= count;
+    }
+    else if (pos > gap_pos)
+    {
+      size_type count = pos - gap_pos;
+      std::copy(p_gap_end, p_gap_end + count, p_gap);
+      p_gap += count;
+      p_gap_end += count;
+    }
+  }
+  void GapBuffer::reallocate(size_type new_capacity)
+  {
+    size_type front_size = p_gap - p_begin;
+    size_type back_size = p_end - p_gap_end;
+
+    pointer new_begin(static_cast<pointer>(operator new[](new_capacity * sizeof(value_type))));
+    pointer new_end = new_begin + new_capacity;
+    std::copy(p_begin, p_gap, new_begin);
+    std::copy(p_gap_end, p_end, new_end - back_size);
+
+    if (p_begin != nullptr)
+      operator delete[](p_begin);
+
+    p_begin = new_begin;
+    p_gap = new_begin + front_size;
+    p_gap_end = new_end - back_size;
+    p_end = new_end;
+  }
+  void GapBuffer::make_room(size_type count)
+  {
+    size_type old_capacity = capacity();
+    if (size() + count <= old_capacity)
+      return;
+
+    if (old_capacity + count > old_capacity * 3)
+      reallocate(old_capacity + count);
+    else
+      reallocate(old_capacity * 3);
+  }
+  size_type GapBuffer::cursor() const
+  {
+    return p_gap - p_begin;
+  }
+  void GapBuffer::move_cursor(size_type pos)
+  {
+    if (pos <= size())
+      move_gap(pos);
+  }
+  void GapBuffer::insert_at_cursor(const_reference val)
+  {
+    if (p_gap == p_gap_end)
+    {
+      value_type copy = val;
+      make_room(1);
+      *p_gap++ = copy;
+      return;
+    }
+    *p_gap++ = val;
+  }
+  void GapBuffer::erase_before_cursor()
+  {
+    if (p_gap != p_begin)
+      p_gap--;
+  }
+  void GapBuffer::erase_after_cursor()
+  {
+    if (p_gap_end != p_end)
+      p_gap_end++;
+  }
+  pointer GapBuffer::data()
+  {
+    move_gap(size());
+    return p_begin;
+  }
+  iterator GapBuffer::begin()
+  {
+    index_iterator start_ptr = index_iterator(this, 0);
+    iterator p_start(&start_ptr);
+    return p_start;
+  }
+  const_iterator GapBuffer::begin() const
+  {
+    index_iterator start_ptr = index_iterator(const_cast<GapBuffer*>(this), 0);
+    const_iterator p_start(&start_ptr);
+    return p_start;
+  }
+  iterator GapBuffer::end()
+  {
+    index_iterator last_ptr = index_iterator(this, size());
+    iterator p_last(&last_ptr);
+    return p_last;
+  }
+  const_iterator GapBuffer::end() const
+  {
+    index_iterator last_ptr = index_iterator(const_cast<GapBuffer*>(this), size());
+    const_iterator p_last(&last_ptr);
+    return p_last;
+  }
+  reference GapBuffer::front()
+  {
+    return (*this)[0];
+  }
+  const_reference GapBuffer::front() const
+  {
+    return (*this)[0];
+  }
+  reference GapBuffer::back()
+  {
+    return (*this)[size()-1];
+  }
+  const_reference GapBuffer::back() const
+  {
+    return (*this)[size()-1];
+  }
+  reference GapBuffer::operator[](size_type pos)
+  {
+    size_type gap_pos = p_gap - p_begin;
+    return pos < gap_pos ? p_begin[pos] : p_gap_end[pos - gap_pos];
+  }
+  const_reference GapBuffer::operator[](size_type pos) const
+  {
+    size_type gap_pos = p_gap - p_begin;
+    return pos < gap_pos ? p_begin[pos] : p_gap_end[pos - gap_pos];
+  }
+  size_type GapBuffer::capacity() const
+  {
+    return p_end - p_begin;
+  }
+  size_type GapBuffer::size() const
+  {
+    return (p_gap - p_begin) + (p_end - p_gap_end);
+  }
+  void GapBuffer::clear()
+  {
+    p_gap = p_begin;
+    p_gap_end = p_end;
+  }
+  bool GapBuffer::empty() const
+  {
+    return p_gap == p_begin && p_gap_end == p_end;
+  }
+  void GapBuffer::erase(const_iterator pos)
+  {
+    size_type position = pos - this->begin();
+    if (position >= size())
+      return;
+
+    move_gap(position);
+    p_gap_end++;
+  }
+  void GapBuffer::erase(const_iterator begin, const_iterator end)
+  {
+    size_type start = begin - this->begin();
+    size_type count = end - begin;
+    if (count == 0)
+      return;
+
+    move_gap(start);
+    p_gap_end += count;
+  }
+  void GapBuffer::insert(const_iterator pos, size_type count, const_reference val)
+  {
+    size_type position = pos - this->begin();
+    if (count == 0 || position > size())
+      return;
+
+    value_type copy = val;
+    make_room(count);
+    move_gap(position);
+    p_gap = std::fill_n(p_gap, count, copy);
+  }
+  void GapBuffer::insert(const_iterator pos, const_iterator begin, const_iterator end)
+  {
+    size_type position = pos - this->begin();
+    if (begin == end || position > size())
+      return;
+
+    // the source range may be this buffer, which moving the gap would disturb
+    Vector tmp;
+    tmp.reserve(end - begin);
+    for (; begin != end; ++begin)
+      tmp.push_back(*begin);
+
+    make_room(tmp.size());
+    move_gap(position);
+    for (size_type i = 0; i < tmp.size(); i++)
+      *p_gap++ = tmp[i];
+  }
+  void GapBuffer::pop_back()
+  {
+    if (empty())
+      return;
+    move_gap(size());
+    p_gap--;
+  }
+  void GapBuffer::pop_front()
+  {
+    if (empty())
+      return;
+    move_gap(0);
+    p_gap_end++;
+  }
+  void GapBuffer::push_back(const_reference val)
+  {
+    move_cursor(size());
+    insert_at_cursor(val);
+  }
+  void GapBuffer::push_front(const_reference val)
+  {
+    move_cursor(0);
+    insert_at_cursor(val);
+  }
+  void GapBuffer::reserve(size_type new_capacity)
+  {
+    if (capacity() < new_capacity)
+      reallocate(new_capacity);
+  }
+  void GapBuffer::shrink_to_fit()
+  {
+    if (capacity() > size())
+      reallocate(size());
+  }
+}  // namespace I2P2
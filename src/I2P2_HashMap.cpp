@@ -0,0 +1,28 @@
+#include "../header/I2P2_HashMap.h"
+
+namespace I2P2
+{
+  reference HashMap::operator[](const_reference key)
+  {
+    std::pair<size_type, bool> slot = _table.find_or_insert(key, &_values);
+    if (slot.second)
+      _values[slot.first] = value_type();
+    return _values[slot.first];
+  }
+  bool HashMap::insert(const_reference key, const_reference val)
+  {
+    // val may live in _values, which an insert can rebuild
+    value_type copy = val;
+    std::pair<size_type, bool> slot = _table.find_or_insert(key, &_values);
+    if (slot.second)
+      _values[slot.first] = copy;
+    return slot.second;
+  }
+  bool HashMap::insert_or_assign(const_reference key, const_reference val)
+  {
+    value_type copy = val;
+    std::pair<size_type, bool> slot = _table.find_or_insert(key, &_values);
+    _values[slot.first] = copy;
+    return slot.second;
+  }
+}  // namespace I2P2
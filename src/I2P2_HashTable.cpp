@@ -0,0 +1,234 @@
+#include "../header/I2P2_HashTable.h"
+#include <cstring>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace I2P2
+{
+  namespace
+  {
+    const int8_t ctrl_empty = -128;
+    const int8_t ctrl_deleted = -2;
+    const size_type min_capacity = hash_table::group_width;
+
+    // bit i set for each of the 16 control bytes from p that matches
+    class group
+    {
+      private:
+#ifdef __SSE2__
+        __m128i _ctrl;
+#else
+        int8_t _ctrl[hash_table::group_width];
+#endif
+
+      public:
+        explicit group(const int8_t *p)
+        {
+#ifdef __SSE2__
+          _ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+#else
+          std::memcpy(_ctrl, p, sizeof(_ctrl));
+#endif
+        }
+        uint32_t match(int8_t h) const
+        {
+#ifdef __SSE2__
+          return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), _ctrl));
+#else
+          uint32_t mask = 0;
+          for (size_type i = 0; i < hash_table::group_width; i++)
+            mask |= static_cast<uint32_t>(_ctrl[i] == h) << i;
+          return mask;
+#endif
+        }
+        uint32_t match_empty() const { return match(ctrl_empty); }
+        // empty and deleted are the only negative values below -1
+        uint32_t match_non_full() const
+        {
+#ifdef __SSE2__
+          return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl));
+#else
+          uint32_t mask = 0;
+          for (size_type i = 0; i < hash_table::group_width; i++)
+            mask |= static_cast<uint32_t>(_ctrl[i] < -1) << i;
+          return mask;
+#endif
+        }
+    };
+
+    inline int8_t h2(uint64_t hash) { return static_cast<int8_t>(hash & 0x7f); }
+    inline size_type h1(uint64_t hash) { return static_cast<size_type>(hash >> 7); }
+  }
+
+  hash_table::hash_table() : _capacity(0), _size(0), _growth_left(0), _rebuilds(0) {}
+
+  size_type hash_table::capacity_for(size_type count)
+  {
+    size_type capacity = min_capacity;
+    while (capacity - capacity / 8 < count)
+      capacity *= 2;
+    return capacity;
+  }
+  uint64_t hash_table::hash(value_type key)
+  {
+    // -0.0 == 0.0, so they must hash alike
+    if (key == 0)
+      key = 0;
+    uint64_t bits = 0;
+    std::memcpy(&bits, &key, sizeof(key));
+    // murmur3 finalizer: every input bit reaches the 7 control bits and the probe position
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    bits *= 0xc4ceb9fe1a85ec53ULL;
+    bits ^= bits >> 33;
+    return bits;
+  }
+
+  void hash_table::set_ctrl(size_type slot, int8_t h)
+  {
+    _ctrl[slot] = h;
+    // the copy past the end, so a group loaded near the end wraps around
+    _ctrl[((slot - (group_width - 1)) & (_capacity - 1)) + (group_width - 1)] = h;
+  }
+  size_type hash_table::find_non_full(uint64_t hash) const
+  {
+    size_type mask = _capacity - 1;
+    size_type pos = h1(hash) & mask;
+    // triangular steps in whole groups reach every group of a power-of-two table
+    for (size_type step = group_width;; step += group_width)
+    {
+      uint32_t non_full = group(&_ctrl[pos]).match_non_full();
+      if (non_full != 0)
+        return (pos + __builtin_ctz(non_full)) & mask;
+      pos = (pos + step) & mask;
+    }
+  }
+  size_type hash_table::find(value_type key) const
+  {
+    if (_size == 0)
+      return npos;
+
+    uint64_t hv = hash(key);
+    size_type mask = _capacity - 1;
+    size_type pos = h1(hv) & mask;
+    for (size_type step = group_width;; step += group_width)
+    {
+      group g(&_ctrl[pos]);
+      for (uint32_t match = g.match(h2(hv)); match != 0; match &= match - 1)
+      {
+        size_type slot = (pos + __builtin_ctz(match)) & mask;
+        if (_keys[slot] == key)
+          return slot;
+      }
+      // an empty slot ends every probe sequence that could have placed key further on
+      if (g.match_empty() != 0)
+        return npos;
+      pos = (pos + step) & mask;
+    }
+  }
+  std::pair<size_type, bool> hash_table::find_or_insert(value_type key, Vector *values)
+  {
+    size_type slot = find(key);
+    if (slot != npos)
+      return std::make_pair(slot, false);
+
+    if (_capacity == 0)
+      resize(min_capacity, values);
+    uint64_t hv = hash(key);
+    slot = find_non_full(hv);
+    if (_growth_left == 0 && _ctrl[slot] == ctrl_empty)
+    {
+      // mostly tombstones: rebuild at the same size, otherwise double
+      size_type new_capacity = _size * 32 <= _capacity * 25 ? _capacity : _capacity * 2;
+      resize(new_capacity, values);
+      slot = find_non_full(hv);
+    }
+    if (_ctrl[slot] == ctrl_empty)
+      _growth_left--;
+    set_ctrl(slot, h2(hv));
+    _keys[slot] = key;
+    _size++;
+    return std::make_pair(slot, true);
+  }
+  void hash_table::erase_at(size_type slot)
+  {
+    size_type mask = _capacity - 1;
+    // if the empty slots around this one leave no full window of group_width, no probe ever
+    // passed it, and it can go back to empty
+    uint32_t empty_after = group(&_ctrl[slot]).match_empty();
+    uint32_t empty_before = group(&_ctrl[(slot - group_width) & mask]).match_empty();
+    bool never_passed = empty_before != 0 && empty_after != 0 &&
+                        static_cast<size_type>(__builtin_ctz(empty_after) + (__builtin_clz(empty_before) - 16)) < group_width;
+    if (never_passed)
+    {
+      set_ctrl(slot, ctrl_empty);
+      _growth_left++;
+    }
+    else
+      set_ctrl(slot, ctrl_deleted);
+    _size--;
+  }
+  void hash_table::resize(size_type new_capacity, Vector *values)
+  {
+    std::vector<int8_t> old_ctrl;
+    old_ctrl.swap(_ctrl);
+    _ctrl.assign(new_capacity + group_width - 1, ctrl_empty);
+    Vector old_keys;
+    old_keys.swap(_keys);
+    _keys.resize_uninitialized(new_capacity);
+    Vector old_values;
+    if (values != nullptr)
+    {
+      old_values.swap(*values);
+      values->resize_uninitialized(new_capacity);
+    }
+
+    size_type old_capacity = _capacity;
+    _capacity = new_capacity;
+    _rebuilds++;
+    _growth_left = new_capacity - new_capacity / 8 - _size;
+    for (size_type i = 0; i < old_capacity; i++)
+    {
+      if (old_ctrl[i] < 0)
+        continue;
+      uint64_t hv = hash(old_keys[i]);
+      size_type slot = find_non_full(hv);
+      set_ctrl(slot, h2(hv));
+      _keys[slot] = old_keys[i];
+      if (values != nullptr)
+        (*values)[slot] = old_values[i];
+    }
+  }
+  void hash_table::reserve(size_type count, Vector *values)
+  {
+    if (count > _size + _growth_left)
+      resize(capacity_for(count), values);
+  }
+  void hash_table::rehash(size_type count, Vector *values)
+  {
+    if (count < _size)
+      count = _size;
+    if (count != 0)
+    {
+      resize(capacity_for(count), values);
+      return;
+    }
+    std::vector<int8_t>().swap(_ctrl);
+    Vector().swap(_keys);
+    if (values != nullptr)
+      Vector().swap(*values);
+    _capacity = 0;
+    _growth_left = 0;
+    _rebuilds++;
+  }
+  void hash_table::clear()
+  {
+    // keeps the slots for reuse; rehash(0) releases them
+    std::fill(_ctrl.begin(), _ctrl.end(), ctrl_empty);
+    _size = 0;
+    _growth_left = _capacity - _capacity / 8;
+  }
+}  // namespace I2P2
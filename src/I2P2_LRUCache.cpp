@@ -0,0 +1,178 @@
+#include "../header/I2P2_LRUCache.h"
+
+namespace I2P2
+{
+  namespace
+  {
+    // a slot is a control byte, a key, a value and a node pointer; the control bytes of the first
+    // group are repeated once past the end
+    const size_type slot_bytes = 1 + 2 * sizeof(value_type) + sizeof(Node*);
+    const size_type ctrl_tail = hash_table::group_width - 1;
+  }
+
+  size_type LRUCache::entries_for(size_type bytes)
+  {
+    // the index is a power of two; for each that fits, the most entries it is reserved for and the
+    // most nodes the rest of the budget pays for
+    size_type best = 0;
+    for (size_type slots = hash_table::capacity_for(1); slots * slot_bytes + ctrl_tail <= bytes; slots *= 2)
+    {
+      size_type by_index = (slots - slots / 8 - 1) * 25 / 32;
+      size_type by_nodes = (bytes - slots * slot_bytes - ctrl_tail) / sizeof(Node);
+      size_type entries = by_index < by_nodes ? by_index : by_nodes;
+      if (entries > best)
+        best = entries;
+    }
+    return best;
+  }
+
+  LRUCache::LRUCache(size_type capacity, capacity_unit unit)
+    : _capacity(unit == bytes ? entries_for(capacity) : capacity), _rebuilds_seen(_index.rebuilds())
+  {
+    if (_capacity != 0)
+      _index.reserve(index_size(_capacity), &_values);
+    sync_nodes();
+  }
+  size_type LRUCache::footprint() const
+  {
+    return _order.size() * sizeof(Node) + _index.bytes() + _values.capacity() * sizeof(value_type) +
+           _nodes.capacity() * sizeof(Node*);
+  }
+
+  void LRUCache::sync_nodes()
+  {
+    if (_index.rebuilds() == _rebuilds_seen)
+      return;
+    _nodes.assign(_index.capacity(), nullptr);
+    for (Node *node = _order.head->next; node != _order.tail; node = node->next)
+      _nodes[_index.find(node->data)] = node;
+    _rebuilds_seen = _index.rebuilds();
+  }
+
+  bool LRUCache::get(const_reference key, reference out)
+  {
+    size_type slot = _index.find(key);
+    if (slot == hash_table::npos)
+      return false;
+    order_list::relink(_order.head->next, _nodes[slot]);
+    out = _values[slot];
+    return true;
+  }
+  const_pointer LRUCache::peek(const_reference key) const
+  {
+    size_type slot = _index.find(key);
+    return slot == hash_table::npos ? nullptr : &_values[slot];
+  }
+  bool LRUCache::put(const_reference key, const_reference val)
+  {
+    value_type copy = val;
+    size_type slot = _index.find(key);
+    if (slot != hash_table::npos)
+    {
+      order_list::relink(_order.head->next, _nodes[slot]);
+      _values[slot] = copy;
+      return false;
+    }
+    if (_capacity == 0)
+      return false;
+
+    Node *node;
+    if (_order._size == _capacity)
+    {
+      // evict: the least recent node takes the new key
+      node = _order.tail->prev;
+      _index.erase_at(_index.find(node->data));
+      node->data = key;
+      order_list::relink(_order.head->next, node);
+    }
+    else
+    {
+      node = _order.new_node(key);
+      node->prev = _order.head;
+      node->next = _order.head->next;
+      _order.head->next->prev = node;
+      _order.head->next = node;
+      _order._size++;
+      I2P2_STAT(count_capacity(_order._stats, _order._size));
+    }
+    slot = _index.find_or_insert(key, &_values).first;
+    sync_nodes();
+    _nodes[slot] = node;
+    _values[slot] = copy;
+    return true;
+  }
+  bool LRUCache::erase(const_reference key)
+  {
+    size_type slot = _index.find(key);
+    if (slot == hash_table::npos)
+      return false;
+    Node *node = _nodes[slot];
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    _order.delete_node(node);
+    _order._size--;
+    _index.erase_at(slot);
+    return true;
+  }
+  void LRUCache::clear()
+  {
+    _order.clear();
+    _index.clear();
+  }
+
+  ShardedLRUCache::ShardedLRUCache(size_type capacity, size_type shard_count, LRUCache::capacity_unit unit)
+  {
+    if (shard_count == 0)
+      shard_count = 1;
+    for (size_type i = 0; i < shard_count; i++)
+      _shards.emplace_back(new shard(capacity / shard_count + (i < capacity % shard_count), unit));
+  }
+  ShardedLRUCache::shard &ShardedLRUCache::shard_of(const_reference key) const
+  {
+    // the table inside each shard probes with the low bits, so pick the shard with the high ones
+    return *_shards[(hash_table::hash(key) >> 32) % _shards.size()];
+  }
+
+  bool ShardedLRUCache::get(const_reference key, reference out)
+  {
+    shard &s = shard_of(key);
+    std::lock_guard<std::mutex> guard(s.lock);
+    return s.cache.get(key, out);
+  }
+  bool ShardedLRUCache::contains(const_reference key) const
+  {
+    shard &s = shard_of(key);
+    std::lock_guard<std::mutex> guard(s.lock);
+    return s.cache.contains(key);
+  }
+  bool ShardedLRUCache::put(const_reference key, const_reference val)
+  {
+    shard &s = shard_of(key);
+    std::lock_guard<std::mutex> guard(s.lock);
+    return s.cache.put(key, val);
+  }
+  bool ShardedLRUCache::erase(const_reference key)
+  {
+    shard &s = shard_of(key);
+    std::lock_guard<std::mutex> guard(s.lock);
+    return s.cache.erase(key);
+  }
+  size_type ShardedLRUCache::size() const
+  {
+    size_type total = 0;
+    for (const std::unique_ptr<shard> &s : _shards)
+    {
+      std::lock_guard<std::mutex> guard(s->lock);
+      total += s->cache.size();
+    }
+    return total;
+  }
+  void ShardedLRUCache::clear()
+  {
+    for (const std::unique_ptr<shard> &s : _shards)
+    {
+      std::lock_guard<std::mutex> guard(s->lock);
+      s->cache.clear();
+    }
+  }
+}  // namespace I2P2
@@ -4,14 +4,14 @@ namespace I2P2
 {
   List::~List()
   {
-    clear();
-    delete head;
-    delete tail;
+    free_nodes();
+    delete_node(head);
+    delete_node(tail);
   }
   List::List()
   {
-    head = new Node(0);
-    tail = new Node(0);
+    head = new_node(0);
+    tail = new_node(0);
     head->next = tail;
     tail->prev = head;
     head->prev = nullptr;
@@ -20,8 +20,9 @@ namespace I2P2
   }
   List::List(const List &rhs)
   {
-    head = new Node(0);
-    tail = new Node(0);
+    I2P2_LATENCY_SCOPE(latency_copy);
+    head = new_node(0);
+    tail = new_node(0);
     head->next = tail;
     tail->prev = head;
     head->prev = nullptr;
@@ -30,9 +31,11 @@ namespace I2P2
 
     for(Node* now = rhs.head->next; now != rhs.tail; now = now->next)
       push_back(now->data);      
+    I2P2_STAT(count_copied(_stats, rhs._size));
   }
   List& List::operator=(const List &rhs)
   {  
+    I2P2_LATENCY_SCOPE(latency_copy);
     if(this == &rhs)
       return *this;
     
@@ -40,6 +43,7 @@ namespace I2P2
 
     for(Node* now = rhs.head->next; now != rhs.tail; now = now->next)
       push_back(now->data);      
+    I2P2_STAT(count_copied(_stats, rhs._size));
 
     return *this;
   }
@@ -67,55 +71,38 @@ namespace I2P2
     const_iterator p_tail(&tail_ptr);
     return p_tail;
   }
-  reference List::front()
-  {
-    return head->next->data;
-  }
-  const_reference List::front() const
-  {
-    return head->next->data;
-  }
-  reference List::back()
-  {
-    return tail->prev->data;
-  }
-  const_reference List::back() const
-  {
-    return tail->prev->data;
-  }
-  size_type List::size() const
+  void List::clear()
   {
-    return _size;
+    I2P2_LATENCY_SCOPE(latency_clear);
+    free_nodes();
   }
-  void List::clear()
+  void List::free_nodes()
   {
     Node* curNode = head->next;
     while (curNode != tail) 
     {
       Node* temp = curNode;
       curNode = curNode->next;
-      delete temp;
+      delete_node(temp);
     }
     head->next = tail;
     tail->prev = head;
     _size = 0;
   }
-  bool List::empty() const
-  {
-    return _size == 0;
-  }
   void List::erase(const_iterator pos)
   {
+    I2P2_LATENCY_SCOPE(latency_erase);
     Node* curnode = pos.node_ref();
 
     curnode->prev->next = curnode->next;
     curnode->next->prev = curnode->prev;
       
-    delete curnode;
+    delete_node(curnode);
     _size--;  
   }
   void List::erase(const_iterator begin, const_iterator end)
   {
+    I2P2_LATENCY_SCOPE(latency_erase);
     Node* start = begin.node_ref();
     Node* finish = end.node_ref();
     Node* tmp_head = start->prev;
@@ -124,7 +111,7 @@ namespace I2P2
     {
       Node* curnode = start;
       start = start->next;
-      delete curnode;
+      delete_node(curnode);
       _size--;
     }
 
@@ -133,18 +120,19 @@ namespace I2P2
   }
   void List::insert(const_iterator pos, size_type count, const_reference val)
   {
+    I2P2_LATENCY_SCOPE(latency_insert);
     if(count == 0)
       return;
 
     Node* targetNode = pos.node_ref();
-    Node* tmp_head = new Node(val);
+    Node* tmp_head = new_node(val);
     Node* tmp_tail = tmp_head;
     count--;
     _size++;
 
     while(count--)
     {
-      tmp_tail->next = new Node(val);
+      tmp_tail->next = new_node(val);
       tmp_tail->next->prev = tmp_tail;
       tmp_tail = tmp_tail->next;
       _size++;
@@ -154,21 +142,23 @@ namespace I2P2
     tmp_head->prev = targetNode->prev;
     tmp_tail->next = targetNode;
     targetNode->prev = tmp_tail;      
+    I2P2_STAT(count_capacity(_stats, _size));
   }
   void List::insert(const_iterator pos, const_iterator begin, const_iterator end)
   {
+    I2P2_LATENCY_SCOPE(latency_insert);
     if(begin != end)
     {
       Node* targetNode = pos.node_ref();
         
-      Node* tmp_head = new Node(*begin);
+      Node* tmp_head = new_node(*begin);
       Node* tmp_tail = tmp_head;
       begin++;
       _size++;
 
       while(begin != end)
       {
-        tmp_tail->next = new Node(*begin);
+        tmp_tail->next = new_node(*begin);
         tmp_tail->next->prev = tmp_tail;
         tmp_tail = tmp_tail->next;
         begin++;
@@ -179,27 +169,31 @@ namespace I2P2
       tmp_head->prev = targetNode->prev;
       tmp_tail->next = targetNode;
       targetNode->prev = tmp_tail;
+      I2P2_STAT(count_capacity(_stats, _size));
     }
   }
   void List::pop_back()
   {
+    I2P2_LATENCY_SCOPE(latency_pop_back);
     Node* now = tail->prev;
     now->prev->next = tail;
     tail->prev = now->prev;
-    delete now;
+    delete_node(now);
     _size--;
   }
   void List::pop_front()
   {
+    I2P2_LATENCY_SCOPE(latency_pop_front);
     Node* now = head->next;
     now->next->prev = head;
     head->next = now->next;
-    delete now;
+    delete_node(now);
     _size--;
   }
   void List::push_back(const_reference val)
   {
-    Node* newnode = new Node(val);
+    I2P2_LATENCY_SCOPE(latency_push_back);
+    Node* newnode = new_node(val);
 
     tail->prev->next = newnode;
     newnode->prev = tail->prev;
@@ -207,10 +201,12 @@ namespace I2P2
     tail->prev = newnode;
 
     _size++;    
+    I2P2_STAT(count_capacity(_stats, _size));
   }
   void List::push_front(const_reference val)
   {
-    Node* newnode = new Node(val);
+    I2P2_LATENCY_SCOPE(latency_push_front);
+    Node* newnode = new_node(val);
 
     head->next->prev = newnode;
     newnode->next = head->next;
@@ -218,5 +214,21 @@ namespace I2P2
     head->next = newnode;
 
     _size++;   
+    I2P2_STAT(count_capacity(_stats, _size));
+  }
+  void List::splice(const_iterator pos, List &other, const_iterator it)
+  {
+    Node* target = pos.node_ref();
+    Node* node = it.node_ref();
+    if (node == target)
+      return;
+    relink(target, node);
+    other._size--;
+    _size++;
+    I2P2_STAT(count_capacity(_stats, _size));
+#ifdef I2P2_STATS
+    if (&other != this)
+      count_handover(other._stats, _stats, sizeof(Node));
+#endif
   }
 }  // namespace I2P2
@@ -0,0 +1,180 @@
+#include "../header/I2P2_PackedVector.h"
+#include <stdexcept>
+
+namespace I2P2
+{
+  PackedVector::PackedVector(unsigned width) : _size(0), _width(width)
+  {
+    if (width < 1 || width > 64)
+      throw std::invalid_argument("PackedVector: width must be 1 to 64");
+    _per_word = 64 / width;
+    _mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    _low = 0;
+    for (unsigned i = 0; i < _per_word; i++)
+      _low |= uint64_t(1) << (i * width);
+    _high = _low << (width - 1);
+  }
+  PackedVector::PackedVector(size_type count, uint64_t val, unsigned width) : PackedVector(width)
+  {
+    resize(count, val);
+  }
+
+  uint64_t PackedVector::live_mask(size_type w) const
+  {
+    size_type fields = _size - w * _per_word;
+    if (fields > _per_word)
+      fields = _per_word;
+    size_type bits = fields * _width;
+    return bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+  }
+  uint64_t PackedVector::nonzero_fields(uint64_t x) const
+  {
+    // adding the low width - 1 bits of a field to all ones in those bits carries into the field's top
+    // bit exactly when they are not all zero, and never further; or-ing x brings in the top bit itself
+    uint64_t rest = broadcast(_mask) & ~_high;
+    return (((x & rest) + rest) | x) & _high;
+  }
+  void PackedVector::move_elements(size_type dst, size_type src, size_type count)
+  {
+    const PackedVector &self = *this;
+    if (dst < src)
+      for (size_type i = 0; i < count; i++)
+        (*this)[dst + i] = self[src + i];
+    else
+      for (size_type i = count; i-- > 0;)
+        (*this)[dst + i] = self[src + i];
+  }
+  void PackedVector::check_same_shape(const PackedVector &rhs) const
+  {
+    if (rhs._width != _width || rhs._size != _size)
+      throw std::invalid_argument("PackedVector: bitwise operands differ in width or size");
+  }
+
+  void PackedVector::resize(size_type count, uint64_t val)
+  {
+    size_type old_size = _size;
+    if (count < old_size)
+    {
+      erase(count, old_size);
+      return;
+    }
+    _words.resize((count + _per_word - 1) / _per_word, 0);
+    _size = count;
+    set(old_size, count, val);
+  }
+  void PackedVector::clear()
+  {
+    _words.clear();
+    _size = 0;
+  }
+
+  void PackedVector::push_back(uint64_t val)
+  {
+    if (_size % _per_word == 0)
+      _words.push_back(0);
+    _size++;
+    (*this)[_size - 1] = val;
+  }
+  void PackedVector::pop_back()
+  {
+    if (_size == 0)
+      return;
+    // keep the field past size() zero
+    (*this)[_size - 1] = 0;
+    _size--;
+    if (_size % _per_word == 0)
+      _words.pop_back();
+  }
+  void PackedVector::insert(size_type pos, size_type count, uint64_t val)
+  {
+    if (count == 0 || pos > _size)
+      return;
+    size_type old_size = _size;
+    _words.resize((old_size + count + _per_word - 1) / _per_word, 0);
+    _size = old_size + count;
+    move_elements(pos + count, pos, old_size - pos);
+    set(pos, pos + count, val);
+  }
+  void PackedVector::erase(size_type first, size_type last)
+  {
+    if (first >= last || last > _size)
+      return;
+    move_elements(first, last, _size - last);
+    size_type new_size = _size - (last - first);
+    set(new_size, _size, 0);
+    _size = new_size;
+    _words.resize((new_size + _per_word - 1) / _per_word);
+  }
+
+  void PackedVector::set(size_type first, size_type last, uint64_t val)
+  {
+    // single fields up to a word boundary, then whole words, then the fields of the last word
+    while (first < last && first % _per_word != 0)
+      (*this)[first++] = val;
+    uint64_t pattern = broadcast(val);
+    for (; last - first >= _per_word; first += _per_word)
+      _words[first / _per_word] = pattern;
+    while (first < last)
+      (*this)[first++] = val;
+  }
+  size_type PackedVector::count(uint64_t val) const
+  {
+    // no field can hold a value wider than the width
+    if (val > _mask)
+      return 0;
+    uint64_t pattern = broadcast(val);
+    size_type matches = 0;
+    for (size_type w = 0; w < _words.size(); w++)
+    {
+      // fields equal to val xor to zero; count the others among the live fields and subtract
+      uint64_t live = live_mask(w);
+      uint64_t differ = nonzero_fields((_words[w] ^ pattern) & live) & live;
+      size_type fields = _size - w * _per_word < _per_word ? _size - w * _per_word : _per_word;
+      matches += fields - __builtin_popcountll(differ);
+    }
+    return matches;
+  }
+  size_type PackedVector::find_first(uint64_t val, size_type from) const
+  {
+    if (val > _mask)
+      return _size;
+    uint64_t pattern = broadcast(val);
+    for (size_type w = from / _per_word; w < _words.size(); w++)
+    {
+      uint64_t live = live_mask(w);
+      if (w == from / _per_word)
+        live &= ~uint64_t(0) << shift_of(from);
+      uint64_t same = ~nonzero_fields(_words[w] ^ pattern) & _high & live;
+      if (same != 0)
+        return w * _per_word + __builtin_ctzll(same) / _width;
+    }
+    return _size;
+  }
+
+  PackedVector &PackedVector::operator&=(const PackedVector &rhs)
+  {
+    check_same_shape(rhs);
+    for (size_type w = 0; w < _words.size(); w++)
+      _words[w] &= rhs._words[w];
+    return *this;
+  }
+  PackedVector &PackedVector::operator|=(const PackedVector &rhs)
+  {
+    check_same_shape(rhs);
+    for (size_type w = 0; w < _words.size(); w++)
+      _words[w] |= rhs._words[w];
+    return *this;
+  }
+  PackedVector &PackedVector::operator^=(const PackedVector &rhs)
+  {
+    check_same_shape(rhs);
+    for (size_type w = 0; w < _words.size(); w++)
+      _words[w] ^= rhs._words[w];
+    return *this;
+  }
+  void PackedVector::flip()
+  {
+    for (size_type w = 0; w < _words.size(); w++)
+      _words[w] = ~_words[w] & live_mask(w);
+  }
+}  // namespace I2P2
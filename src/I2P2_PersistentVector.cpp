@@ -0,0 +1,466 @@
+#include "../header/I2P2_PersistentVector.h"
+#include <atomic>
+#include <algorithm>
+
+namespace I2P2
+{
+  struct pvec_node
+  {
+    std::atomic<size_type> refs;
+    size_type size;
+    unsigned height;
+    pvec_node(size_type s, unsigned h) : refs(1), size(s), height(h) {}
+  };
+
+  namespace
+  {
+    const size_type leaf_cap = PersistentVector::leaf_capacity;
+
+    struct pvec_leaf : pvec_node
+    {
+      value_type data[leaf_cap];
+      pvec_leaf(const_pointer src, size_type count) : pvec_node(count, 0)
+      {
+        std::copy(src, src + count, data);
+      }
+    };
+
+    struct pvec_branch : pvec_node
+    {
+      pvec_node* left;
+      pvec_node* right;
+      pvec_branch(pvec_node* l, pvec_node* r)
+        : pvec_node(l->size + r->size, 1 + std::max(l->height, r->height)), left(l), right(r) {}
+    };
+
+    /* Functions below take node arguments as borrowed and return owned references,
+       except where a parameter is documented as consumed. */
+    pvec_leaf* as_leaf(pvec_node* n)
+    {
+      return static_cast<pvec_leaf*>(n);
+    }
+    pvec_branch* as_branch(pvec_node* n)
+    {
+      return static_cast<pvec_branch*>(n);
+    }
+    unsigned height(const pvec_node* n)
+    {
+      return n == nullptr ? 0 : n->height;
+    }
+    pvec_node* retain(pvec_node* n)
+    {
+      if (n != nullptr)
+        n->refs.fetch_add(1, std::memory_order_relaxed);
+      return n;
+    }
+    void release(pvec_node* n)
+    {
+      if (n == nullptr || n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+      if (n->height == 0)
+      {
+        delete as_leaf(n);
+        return;
+      }
+      pvec_branch* b = as_branch(n);
+      release(b->left);
+      release(b->right);
+      delete b;
+    }
+    // consumes l and r
+    pvec_node* make_branch(pvec_node* l, pvec_node* r)
+    {
+      return new pvec_branch(l, r);
+    }
+    // consumes t = (a, (b, c)), returns ((a, b), c)
+    pvec_node* rotate_left(pvec_node* t)
+    {
+      pvec_branch* top = as_branch(t);
+      pvec_branch* r = as_branch(top->right);
+      pvec_node* result = make_branch(make_branch(retain(top->left), retain(r->left)), retain(r->right));
+      release(t);
+      return result;
+    }
+    // consumes t = ((a, b), c), returns (a, (b, c))
+    pvec_node* rotate_right(pvec_node* t)
+    {
+      pvec_branch* top = as_branch(t);
+      pvec_branch* l = as_branch(top->left);
+      pvec_node* result = make_branch(retain(l->left), make_branch(retain(l->right), retain(top->right)));
+      release(t);
+      return result;
+    }
+    // l and r differ in height by at most one; neighbouring leaves that fit in one chunk are merged
+    pvec_node* join_balanced(pvec_node* l, pvec_node* r)
+    {
+      if (l->height == 0 && r->height == 0 && l->size + r->size <= leaf_cap)
+      {
+        pvec_leaf* merged = new pvec_leaf(as_leaf(l)->data, l->size);
+        std::copy(as_leaf(r)->data, as_leaf(r)->data + r->size, merged->data + l->size);
+        merged->size += r->size;
+        return merged;
+      }
+      return make_branch(retain(l), retain(r));
+    }
+    // height(l) > height(r) + 1
+    pvec_node* join_right(pvec_node* l, pvec_node* r)
+    {
+      pvec_branch* b = as_branch(l);
+      pvec_node* a = b->left;
+      pvec_node* c = b->right;
+
+      if (height(c) <= height(r) + 1)
+      {
+        pvec_node* t = join_balanced(c, r);
+        if (height(t) <= height(a) + 1)
+          return make_branch(retain(a), t);
+        return rotate_left(make_branch(retain(a), rotate_right(t)));
+      }
+
+      pvec_node* t = join_right(c, r);
+      if (height(t) <= height(a) + 1)
+        return make_branch(retain(a), t);
+      return rotate_left(make_branch(retain(a), t));
+    }
+    // height(r) > height(l) + 1
+    pvec_node* join_left(pvec_node* l, pvec_node* r)
+    {
+      pvec_branch* b = as_branch(r);
+      pvec_node* c = b->left;
+      pvec_node* a = b->right;
+
+      if (height(c) <= height(l) + 1)
+      {
+        pvec_node* t = join_balanced(l, c);
+        if (height(t) <= height(a) + 1)
+          return make_branch(t, retain(a));
+        return rotate_right(make_branch(rotate_left(t), retain(a)));
+      }
+
+      pvec_node* t = join_left(l, c);
+      if (height(t) <= height(a) + 1)
+        return make_branch(t, retain(a));
+      return rotate_right(make_branch(t, retain(a)));
+    }
+    pvec_node* join(pvec_node* l, pvec_node* r)
+    {
+      if (l == nullptr)
+        return retain(r);
+      if (r == nullptr)
+        return retain(l);
+      if (l->height > r->height + 1)
+        return join_right(l, r);
+      if (r->height > l->height + 1)
+        return join_left(l, r);
+      return join_balanced(l, r);
+    }
+    void split(pvec_node* t, size_type pos, pvec_node* &l, pvec_node* &r)
+    {
+      if (t == nullptr || pos == 0)
+      {
+        l = nullptr;
+        r = retain(t);
+        return;
+      }
+      if (pos >= t->size)
+      {
+        l = retain(t);
+        r = nullptr;
+        return;
+      }
+      if (t->height == 0)
+      {
+        l = new pvec_leaf(as_leaf(t)->data, pos);
+        r = new pvec_leaf(as_leaf(t)->data + pos, t->size - pos);
+        return;
+      }
+
+      pvec_branch* b = as_branch(t);
+      size_type left_size = b->left->size;
+      pvec_node* part_l;
+      pvec_node* part_r;
+      if (pos < left_size)
+      {
+        split(b->left, pos, part_l, part_r);
+        l = part_l;
+        r = join(part_r, b->right);
+        release(part_r);
+      }
+      else
+      {
+        split(b->right, pos - left_size, part_l, part_r);
+        l = join(b->left, part_l);
+        r = part_r;
+        release(part_l);
+      }
+    }
+    pvec_node* set_copy(pvec_node* t, size_type pos, const_reference val)
+    {
+      if (t->height == 0)
+      {
+        pvec_leaf* copy = new pvec_leaf(as_leaf(t)->data, t->size);
+        copy->data[pos] = val;
+        return copy;
+      }
+
+      pvec_branch* b = as_branch(t);
+      if (pos < b->left->size)
+        return make_branch(set_copy(b->left, pos, val), retain(b->right));
+      return make_branch(retain(b->left), set_copy(b->right, pos - b->left->size, val));
+    }
+    // returns nullptr when the rightmost leaf is already full
+    pvec_node* append_copy(pvec_node* t, const_reference val)
+    {
+      if (t->height == 0)
+      {
+        if (t->size == leaf_cap)
+          return nullptr;
+        pvec_leaf* copy = new pvec_leaf(as_leaf(t)->data, t->size);
+        copy->data[copy->size++] = val;
+        return copy;
+      }
+
+      pvec_branch* b = as_branch(t);
+      pvec_node* right = append_copy(b->right, val);
+      if (right == nullptr)
+        return nullptr;
+      return make_branch(retain(b->left), right);
+    }
+    /* Appends leaf (consumed) at the right end of the tree in slot, which the caller owns. Branches
+       with no other owner along the right spine are updated and rotated in place, so a chunk costs
+       one new branch; the first shared node met is joined persistently, which leaves a fresh,
+       owned spine for the next chunk. */
+    void append_in_place(pvec_node* &slot, pvec_node* leaf)
+    {
+      pvec_node* t = slot;
+      if (t == nullptr)
+      {
+        slot = leaf;
+        return;
+      }
+      if (t->height == 0 || t->refs.load(std::memory_order_acquire) != 1)
+      {
+        slot = join(t, leaf);
+        release(leaf);
+        release(t);
+        return;
+      }
+
+      pvec_branch* b = as_branch(t);
+      size_type added = leaf->size;
+      append_in_place(b->right, leaf);
+      b->size += added;
+      if (height(b->right) <= height(b->left) + 1)
+      {
+        b->height = 1 + std::max(height(b->left), height(b->right));
+        return;
+      }
+
+      // right-heavy by two: (a, (x, y)) becomes ((a, x), y), reusing both branches
+      pvec_branch* r = as_branch(b->right);
+      if (r->refs.load(std::memory_order_acquire) != 1 || height(r->left) > height(r->right))
+      {
+        slot = join(b->left, b->right);
+        release(t);
+        return;
+      }
+      b->right = r->left;
+      b->size = b->left->size + b->right->size;
+      b->height = 1 + std::max(height(b->left), height(b->right));
+      r->left = b;
+      r->size = b->size + r->right->size;
+      r->height = 1 + std::max(height(r->left), height(r->right));
+      slot = r;
+    }
+    pvec_leaf* find_leaf(pvec_node* t, size_type &pos)
+    {
+      while (t->height != 0)
+      {
+        pvec_branch* b = as_branch(t);
+        if (pos < b->left->size)
+          t = b->left;
+        else
+        {
+          pos -= b->left->size;
+          t = b->right;
+        }
+      }
+      return as_leaf(t);
+    }
+  }
+
+  const size_type PersistentVector::leaf_capacity;
+
+  //transient implementation
+  PersistentVector::transient::~transient()
+  {
+    release(root);
+  }
+  PersistentVector::transient::transient() : root(nullptr), tail_size(0) {}
+  PersistentVector::transient::transient(const PersistentVector &base) : root(retain(base.root)), tail_size(0) {}
+  void PersistentVector::transient::flush()
+  {
+    if (tail_size == 0)
+      return;
+
+    append_in_place(root, new pvec_leaf(tail, tail_size));
+    tail_size = 0;
+  }
+  size_type PersistentVector::transient::size() const
+  {
+    return (root == nullptr ? 0 : root->size) + tail_size;
+  }
+  const_reference PersistentVector::transient::operator[](size_type pos) const
+  {
+    size_type root_size = root == nullptr ? 0 : root->size;
+    if (pos >= root_size)
+      return tail[pos - root_size];
+    return find_leaf(root, pos)->data[pos];
+  }
+  void PersistentVector::transient::push_back(const_reference val)
+  {
+    if (tail_size == leaf_capacity)
+      flush();
+    tail[tail_size++] = val;
+  }
+  void PersistentVector::transient::set(size_type pos, const_reference val)
+  {
+    size_type root_size = root == nullptr ? 0 : root->size;
+    if (pos >= root_size)
+    {
+      tail[pos - root_size] = val;
+      return;
+    }
+
+    // a node only this transient can reach (refs == 1 under a uniquely owned parent) is written in place
+    pvec_node** slot = &root;
+    while (true)
+    {
+      pvec_node* now = *slot;
+      if (now->refs.load(std::memory_order_acquire) != 1)
+      {
+        *slot = set_copy(now, pos, val);
+        release(now);
+        return;
+      }
+      if (now->height == 0)
+      {
+        as_leaf(now)->data[pos] = val;
+        return;
+      }
+
+      pvec_branch* b = as_branch(now);
+      if (pos < b->left->size)
+        slot = &b->left;
+      else
+      {
+        pos -= b->left->size;
+        slot = &b->right;
+      }
+    }
+  }
+  PersistentVector PersistentVector::transient::persistent()
+  {
+    flush();
+    return PersistentVector(retain(root));
+  }
+
+  //PersistentVector implementation
+  PersistentVector::~PersistentVector()
+  {
+    release(root);
+  }
+  PersistentVector::PersistentVector() : root(nullptr) {}
+  PersistentVector::PersistentVector(pvec_node* r) : root(r) {}
+  PersistentVector::PersistentVector(const PersistentVector &rhs) : root(retain(rhs.root)) {}
+  PersistentVector::PersistentVector(const Vector &vec) : root(nullptr)
+  {
+    transient builder;
+    for (size_type i = 0; i < vec.size(); i++)
+      builder.push_back(vec[i]);
+    *this = builder.persistent();
+  }
+  PersistentVector& PersistentVector::operator=(const PersistentVector &rhs)
+  {
+    pvec_node* new_root = retain(rhs.root);
+    release(root);
+    root = new_root;
+    return *this;
+  }
+  size_type PersistentVector::size() const
+  {
+    return root == nullptr ? 0 : root->size;
+  }
+  bool PersistentVector::empty() const
+  {
+    return root == nullptr;
+  }
+  const_reference PersistentVector::operator[](size_type pos) const
+  {
+    return find_leaf(root, pos)->data[pos];
+  }
+  const_reference PersistentVector::front() const
+  {
+    return (*this)[0];
+  }
+  const_reference PersistentVector::back() const
+  {
+    return (*this)[size() - 1];
+  }
+  PersistentVector PersistentVector::set(size_type pos, const_reference val) const
+  {
+    if (pos >= size())
+      return *this;
+    return PersistentVector(set_copy(root, pos, val));
+  }
+  PersistentVector PersistentVector::push_back(const_reference val) const
+  {
+    if (root == nullptr)
+      return PersistentVector(new pvec_leaf(&val, 1));
+
+    pvec_node* appended = append_copy(root, val);
+    if (appended != nullptr)
+      return PersistentVector(appended);
+
+    pvec_node* chunk = new pvec_leaf(&val, 1);
+    PersistentVector result(join(root, chunk));
+    release(chunk);
+    return result;
+  }
+  PersistentVector PersistentVector::concat(const PersistentVector &rhs) const
+  {
+    return PersistentVector(join(root, rhs.root));
+  }
+  PersistentVector PersistentVector::slice(size_type begin, size_type end) const
+  {
+    end = std::min(end, size());
+    if (begin >= end)
+      return PersistentVector();
+
+    pvec_node* head;
+    pvec_node* rest;
+    split(root, end, head, rest);
+    release(rest);
+
+    pvec_node* unused;
+    pvec_node* result;
+    split(head, begin, unused, result);
+    release(unused);
+    release(head);
+    return PersistentVector(result);
+  }
+  Vector PersistentVector::to_vector() const
+  {
+    Vector result;
+    result.reserve(size());
+    for_each([&result](const_reference val) { result.push_back(val); });
+    return result;
+  }
+  const_pointer PersistentVector::chunk(size_type pos, size_type &count) const
+  {
+    pvec_leaf* leaf = find_leaf(root, pos);
+    count = leaf->size - pos;
+    return leaf->data + pos;
+  }
+}  // namespace I2P2
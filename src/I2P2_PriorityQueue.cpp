@@ -0,0 +1,271 @@
+#include "../header/I2P2_PriorityQueue.h"
+#include <stdexcept>
+
+namespace I2P2
+{
+  struct heap_kernel
+  {
+    void (*sift_up)(pointer heap, size_type arity, size_type pos, value_type val);
+    void (*sift_down)(pointer heap, size_type arity, size_type n, size_type pos, value_type val);
+    // fills the hole at the root of the n-element heap with val, which was element n
+    void (*pop)(pointer heap, size_type arity, size_type n, value_type val);
+  };
+
+  namespace
+  {
+    struct max_before
+    {
+      bool operator()(value_type a, value_type b) const { return b < a; }
+    };
+    struct min_before
+    {
+      bool operator()(value_type a, value_type b) const { return a < b; }
+    };
+
+    // D is the arity when it is known at compile time, so the index arithmetic becomes shifts; 0 reads it from arity
+    template <size_type D, class Before>
+    struct heap_loops
+    {
+      static size_type best_child(const_pointer heap, size_type first, size_type last)
+      {
+        Before before;
+        size_type best = first;
+        for (size_type child = first + 1; child < last; child++)
+          best = before(heap[child], heap[best]) ? child : best;
+        return best;
+      }
+      static void sift_up(pointer heap, size_type arity, size_type pos, value_type val)
+      {
+        const size_type d = D ? D : arity;
+        Before before;
+        while (pos > 0)
+        {
+          size_type parent = (pos - 1) / d;
+          if (!before(val, heap[parent]))
+            break;
+          heap[pos] = heap[parent];
+          pos = parent;
+        }
+        heap[pos] = val;
+      }
+      static void sift_down(pointer heap, size_type arity, size_type n, size_type pos, value_type val)
+      {
+        const size_type d = D ? D : arity;
+        Before before;
+        for (;;)
+        {
+          size_type first = pos * d + 1;
+          if (first >= n)
+            break;
+          size_type best = best_child(heap, first, first + d < n ? first + d : n);
+          if (!before(heap[best], val))
+            break;
+          heap[pos] = heap[best];
+          pos = best;
+        }
+        heap[pos] = val;
+      }
+      static void pop(pointer heap, size_type arity, size_type n, value_type val)
+      {
+        // down to a leaf without comparing against val, then back up: fewer comparisons, since
+        // the former last element rarely climbs far
+        const size_type d = D ? D : arity;
+        size_type pos = 0;
+        for (;;)
+        {
+          size_type first = pos * d + 1;
+          if (first >= n)
+            break;
+          size_type best = best_child(heap, first, first + d < n ? first + d : n);
+          heap[pos] = heap[best];
+          pos = best;
+        }
+        sift_up(heap, arity, pos, val);
+      }
+    };
+
+// a brace list of function addresses, so the table is constant-initialized before any static constructor runs
+#define I2P2_HEAP_KERNEL(D, Before) \
+  {&heap_loops<D, Before>::sift_up, &heap_loops<D, Before>::sift_down, &heap_loops<D, Before>::pop}
+
+    const heap_kernel kernels[2][4] = {
+      {I2P2_HEAP_KERNEL(0, max_before), I2P2_HEAP_KERNEL(2, max_before), I2P2_HEAP_KERNEL(4, max_before),
+       I2P2_HEAP_KERNEL(8, max_before)},
+      {I2P2_HEAP_KERNEL(0, min_before), I2P2_HEAP_KERNEL(2, min_before), I2P2_HEAP_KERNEL(4, min_before),
+       I2P2_HEAP_KERNEL(8, min_before)},
+    };
+
+#undef I2P2_HEAP_KERNEL
+
+    const heap_kernel *select_kernel(size_type arity, heap_order order)
+    {
+      size_type fixed = arity == 2 ? 1 : arity == 4 ? 2 : arity == 8 ? 3 : 0;
+      return &kernels[order == min_first][fixed];
+    }
+  }
+
+  PriorityQueue::PriorityQueue(size_type arity, heap_order order)
+    : _arity(arity), _order(order), _kernel(select_kernel(arity, order))
+  {
+    if (arity < 2)
+      throw std::invalid_argument("PriorityQueue: arity must be at least 2");
+  }
+  PriorityQueue::PriorityQueue(VectorView src, size_type arity, heap_order order) : PriorityQueue(arity, order)
+  {
+    assign(src);
+  }
+
+  void PriorityQueue::make_heap()
+  {
+    size_type n = _heap.size();
+    if (n < 2)
+      return;
+    // bottom-up: every parent from the last one back to the root, O(n) in total
+    pointer heap = _heap.data();
+    for (size_type pos = (n - 2) / _arity + 1; pos-- > 0;)
+      _kernel->sift_down(heap, _arity, n, pos, heap[pos]);
+  }
+
+  void PriorityQueue::push(const_reference val)
+  {
+    value_type copy = val;
+    _heap.push_back(copy);
+    _kernel->sift_up(_heap.data(), _arity, _heap.size() - 1, copy);
+  }
+  void PriorityQueue::pop()
+  {
+    if (_heap.empty())
+      return;
+    value_type last = _heap.back();
+    _heap.pop_back();
+    if (!_heap.empty())
+      _kernel->pop(_heap.data(), _arity, _heap.size(), last);
+  }
+  value_type PriorityQueue::push_pop(value_type val)
+  {
+    // val leaves at once unless the top goes before it
+    if (_heap.empty() || !(_order == max_first ? val < _heap[0] : _heap[0] < val))
+      return val;
+    value_type top = _heap[0];
+    _kernel->sift_down(_heap.data(), _arity, _heap.size(), 0, val);
+    return top;
+  }
+  void PriorityQueue::assign(VectorView src)
+  {
+    _heap.clear();
+    _heap.append(src.data(), src.size());
+    make_heap();
+  }
+  void PriorityQueue::heapify(Vector &src)
+  {
+    _heap.swap(src);
+    src.clear();
+    make_heap();
+  }
+
+  const size_type IndexedPriorityQueue::npos;
+
+  IndexedPriorityQueue::IndexedPriorityQueue(size_type arity, heap_order order) : _arity(arity), _order(order)
+  {
+    if (arity < 2)
+      throw std::invalid_argument("IndexedPriorityQueue: arity must be at least 2");
+  }
+
+  void IndexedPriorityQueue::place(size_type pos, value_type key, size_type id)
+  {
+    _keys[pos] = key;
+    _ids[pos] = id;
+    _pos[id] = pos;
+  }
+  void IndexedPriorityQueue::sift_up(size_type pos, value_type key, size_type id)
+  {
+    while (pos > 0)
+    {
+      size_type parent = (pos - 1) / _arity;
+      if (!before(key, _keys[parent]))
+        break;
+      place(pos, _keys[parent], _ids[parent]);
+      pos = parent;
+    }
+    place(pos, key, id);
+  }
+  void IndexedPriorityQueue::sift_down(size_type pos, value_type key, size_type id)
+  {
+    const_pointer keys = _keys.data();
+    size_type n = _ids.size();
+    for (;;)
+    {
+      size_type first = pos * _arity + 1;
+      if (first >= n)
+        break;
+      size_type last = first + _arity < n ? first + _arity : n;
+      size_type best = first;
+      for (size_type child = first + 1; child < last; child++)
+        best = before(keys[child], keys[best]) ? child : best;
+      if (!before(keys[best], key))
+        break;
+      place(pos, keys[best], _ids[best]);
+      pos = best;
+    }
+    place(pos, key, id);
+  }
+  void IndexedPriorityQueue::remove_at(size_type pos)
+  {
+    _pos[_ids[pos]] = npos;
+    value_type key = _keys.back();
+    size_type id = _ids.back();
+    _keys.pop_back();
+    _ids.pop_back();
+    if (pos == _ids.size())
+      return;
+    // the last element fills the hole, then moves whichever way its priority needs
+    if (pos > 0 && before(key, _keys[(pos - 1) / _arity]))
+      sift_up(pos, key, id);
+    else
+      sift_down(pos, key, id);
+  }
+
+  void IndexedPriorityQueue::push(size_type id, const_reference priority)
+  {
+    if (contains(id))
+    {
+      update(id, priority);
+      return;
+    }
+    value_type key = priority;
+    if (id >= _pos.size())
+      _pos.resize(id + 1, npos);
+    _keys.push_back(key);
+    _ids.push_back(id);
+    sift_up(_ids.size() - 1, key, id);
+  }
+  void IndexedPriorityQueue::update(size_type id, const_reference priority)
+  {
+    value_type key = priority;
+    size_type pos = _pos[id];
+    if (before(key, _keys[pos]))
+      sift_up(pos, key, id);
+    else
+      sift_down(pos, key, id);
+  }
+  void IndexedPriorityQueue::pop()
+  {
+    if (_ids.empty())
+      return;
+    remove_at(0);
+  }
+  bool IndexedPriorityQueue::erase(size_type id)
+  {
+    if (!contains(id))
+      return false;
+    remove_at(_pos[id]);
+    return true;
+  }
+  void IndexedPriorityQueue::clear()
+  {
+    for (size_type id : _ids)
+      _pos[id] = npos;
+    _keys.clear();
+    _ids.clear();
+  }
+}  // namespace I2P2
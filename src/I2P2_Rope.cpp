@@ -0,0 +1,436 @@
+#include "../header/I2P2_Rope.h"
+#include "../header/I2P2_Vector.h"
+#include <algorithm>
+
+namespace I2P2
+{
+  struct rope_node
+  {
+    bool leaf;
+    size_type size;
+    rope_node(bool l) : leaf(l), size(0) {}
+  };
+
+  namespace
+  {
+    const size_type leaf_cap = Rope::leaf_capacity;
+    const size_type fanout = Rope::fanout;
+
+    // both node kinds have room for one extra entry, so an insert can overflow before it splits
+    struct rope_leaf : rope_node
+    {
+      value_type data[leaf_cap + 1];
+      rope_leaf() : rope_node(true) {}
+    };
+
+    struct rope_inner : rope_node
+    {
+      size_type n;
+      rope_node* child[fanout + 1];
+      size_type counts[fanout + 1];
+      rope_inner() : rope_node(false), n(0) {}
+    };
+
+    rope_leaf* as_leaf(rope_node* node)
+    {
+      return static_cast<rope_leaf*>(node);
+    }
+    rope_inner* as_inner(rope_node* node)
+    {
+      return static_cast<rope_inner*>(node);
+    }
+    size_type entries(rope_node* node)
+    {
+      return node->leaf ? node->size : as_inner(node)->n;
+    }
+    bool underflow(rope_node* node)
+    {
+      return node->leaf ? node->size < leaf_cap / 4 : as_inner(node)->n < fanout / 4;
+    }
+    void destroy(rope_node* node)
+    {
+      if (node->leaf)
+      {
+        delete as_leaf(node);
+        return;
+      }
+      rope_inner* in = as_inner(node);
+      for (size_type i = 0; i < in->n; i++)
+        destroy(in->child[i]);
+      delete in;
+    }
+    rope_node* clone(rope_node* node)
+    {
+      if (node->leaf)
+      {
+        rope_leaf* copy = new rope_leaf();
+        std::copy(as_leaf(node)->data, as_leaf(node)->data + node->size, copy->data);
+        copy->size = node->size;
+        return copy;
+      }
+
+      rope_inner* in = as_inner(node);
+      rope_inner* copy = new rope_inner();
+      for (size_type i = 0; i < in->n; i++)
+      {
+        copy->child[i] = clone(in->child[i]);
+        copy->counts[i] = in->counts[i];
+      }
+      copy->n = in->n;
+      copy->size = in->size;
+      return copy;
+    }
+    rope_leaf* find_leaf(rope_node* node, size_type &pos)
+    {
+      while (!node->leaf)
+      {
+        rope_inner* in = as_inner(node);
+        size_type i = 0;
+        while (pos >= in->counts[i])
+          pos -= in->counts[i++];
+        node = in->child[i];
+      }
+      return as_leaf(node);
+    }
+    // moves the upper part of an overflowing node into a new right sibling; appends split off only
+    // the last element so that building by push_back leaves full leaves behind
+    rope_node* split(rope_node* node, bool append = false)
+    {
+      if (node->leaf)
+      {
+        rope_leaf* l = as_leaf(node);
+        rope_leaf* r = new rope_leaf();
+        size_type half = append ? l->size - 1 : l->size / 2;
+        std::copy(l->data + half, l->data + l->size, r->data);
+        r->size = l->size - half;
+        l->size = half;
+        return r;
+      }
+
+      rope_inner* l = as_inner(node);
+      rope_inner* r = new rope_inner();
+      size_type half = l->n / 2;
+      for (size_type i = half; i < l->n; i++)
+      {
+        r->child[r->n] = l->child[i];
+        r->counts[r->n] = l->counts[i];
+        r->size += l->counts[i];
+        r->n++;
+      }
+      l->n = half;
+      l->size -= r->size;
+      return r;
+    }
+    // returns the new right sibling when node had to split
+    rope_node* insert_at(rope_node* node, size_type pos, const_reference val)
+    {
+      if (node->leaf)
+      {
+        rope_leaf* l = as_leaf(node);
+        std::copy_backward(l->data + pos, l->data + l->size, l->data + l->size + 1);
+        l->data[pos] = val;
+        l->size++;
+        return l->size > leaf_cap ? split(l, pos + 1 == l->size) : nullptr;
+      }
+
+      rope_inner* in = as_inner(node);
+      size_type i = 0;
+      while (i + 1 < in->n && pos > in->counts[i])
+        pos -= in->counts[i++];
+
+      rope_node* sibling = insert_at(in->child[i], pos, val);
+      in->counts[i] = in->child[i]->size;
+      in->size++;
+      if (sibling == nullptr)
+        return nullptr;
+
+      for (size_type j = in->n; j > i + 1; j--)
+      {
+        in->child[j] = in->child[j - 1];
+        in->counts[j] = in->counts[j - 1];
+      }
+      in->child[i + 1] = sibling;
+      in->counts[i + 1] = sibling->size;
+      in->n++;
+      return in->n > fanout ? split(in) : nullptr;
+    }
+    // folds child b into child a (b == a + 1) when both fit in one node, otherwise evens them out
+    void rebalance(rope_inner* parent, size_type a)
+    {
+      size_type b = a + 1;
+      rope_node* left = parent->child[a];
+      rope_node* right = parent->child[b];
+      size_type limit = left->leaf ? leaf_cap : fanout;
+      size_type total = entries(left) + entries(right);
+
+      if (left->leaf)
+      {
+        rope_leaf* l = as_leaf(left);
+        rope_leaf* r = as_leaf(right);
+        size_type target = total <= limit ? total : total / 2;
+        if (l->size < target)
+        {
+          size_type move = target - l->size;
+          std::copy(r->data, r->data + move, l->data + l->size);
+          std::copy(r->data + move, r->data + r->size, r->data);
+          l->size += move;
+          r->size -= move;
+        }
+        else
+        {
+          size_type move = l->size - target;
+          std::copy_backward(r->data, r->data + r->size, r->data + r->size + move);
+          std::copy(l->data + target, l->data + l->size, r->data);
+          l->size -= move;
+          r->size += move;
+        }
+      }
+      else
+      {
+        rope_inner* l = as_inner(left);
+        rope_inner* r = as_inner(right);
+        size_type target = total <= limit ? total : total / 2;
+        while (l->n < target)
+        {
+          l->child[l->n] = r->child[0];
+          l->counts[l->n] = r->counts[0];
+          l->size += r->counts[0];
+          r->size -= r->counts[0];
+          l->n++;
+          for (size_type j = 1; j < r->n; j++)
+          {
+            r->child[j - 1] = r->child[j];
+            r->counts[j - 1] = r->counts[j];
+          }
+          r->n--;
+        }
+        while (l->n > target)
+        {
+          for (size_type j = r->n; j > 0; j--)
+          {
+            r->child[j] = r->child[j - 1];
+            r->counts[j] = r->counts[j - 1];
+          }
+          l->n--;
+          r->child[0] = l->child[l->n];
+          r->counts[0] = l->counts[l->n];
+          l->size -= r->counts[0];
+          r->size += r->counts[0];
+          r->n++;
+        }
+      }
+
+      parent->counts[a] = left->size;
+      parent->counts[b] = right->size;
+      if (entries(right) != 0)
+        return;
+
+      if (right->leaf)
+        delete as_leaf(right);
+      else
+        delete as_inner(right);
+      for (size_type j = b + 1; j < parent->n; j++)
+      {
+        parent->child[j - 1] = parent->child[j];
+        parent->counts[j - 1] = parent->counts[j];
+      }
+      parent->n--;
+    }
+    void erase_at(rope_node* node, size_type pos)
+    {
+      if (node->leaf)
+      {
+        rope_leaf* l = as_leaf(node);
+        std::copy(l->data + pos + 1, l->data + l->size, l->data + pos);
+        l->size--;
+        return;
+      }
+
+      rope_inner* in = as_inner(node);
+      size_type i = 0;
+      while (pos >= in->counts[i])
+        pos -= in->counts[i++];
+
+      erase_at(in->child[i], pos);
+      in->counts[i]--;
+      in->size--;
+      if (underflow(in->child[i]) && in->n > 1)
+        rebalance(in, i + 1 < in->n ? i : i - 1);
+    }
+  }
+
+  const size_type Rope::leaf_capacity;
+  const size_type Rope::fanout;
+
+  Rope::~Rope()
+  {
+    destroy(root);
+  }
+  Rope::Rope()
+  {
+    root = new rope_leaf();
+  }
+  Rope::Rope(const Rope &rhs)
+  {
+    root = clone(rhs.root);
+  }
+  Rope& Rope::operator=(const Rope &rhs)
+  {
+    if (this == &rhs)
+      return *this;
+
+    rope_node* new_root = clone(rhs.root);
+    destroy(root);
+    root = new_root;
+    return *this;
+  }
+  void Rope::insert_one(size_type pos, const_reference val)
+  {
+    rope_node* sibling = insert_at(root, pos, val);
+    if (sibling == nullptr)
+      return;
+
+    rope_inner* new_root = new rope_inner();
+    new_root->child[0] = root;
+    new_root->child[1] = sibling;
+    new_root->counts[0] = root->size;
+    new_root->counts[1] = sibling->size;
+    new_root->n = 2;
+    new_root->size = root->size + sibling->size;
+    root = new_root;
+  }
+  void Rope::erase_one(size_type pos)
+  {
+    erase_at(root, pos);
+    while (!root->leaf && as_inner(root)->n == 1)
+    {
+      rope_inner* old_root = as_inner(root);
+      root = old_root->child[0];
+      delete old_root;
+    }
+  }
+  const_pointer Rope::chunk(size_type pos, size_type &count) const
+  {
+    rope_leaf* leaf = find_leaf(root, pos);
+    count = leaf->size - pos;
+    return leaf->data + pos;
+  }
+  iterator Rope::begin()
+  {
+    index_iterator start_ptr = index_iterator(this, 0);
+    iterator p_start(&start_ptr);
+    return p_start;
+  }
+  const_iterator Rope::begin() const
+  {
+    index_iterator start_ptr = index_iterator(const_cast<Rope*>(this), 0);
+    const_iterator p_start(&start_ptr);
+    return p_start;
+  }
+  iterator Rope::end()
+  {
+    index_iterator last_ptr = index_iterator(this, size());
+    iterator p_last(&last_ptr);
+    return p_last;
+  }
+  const_iterator Rope::end() const
+  {
+    index_iterator last_ptr = index_iterator(const_cast<Rope*>(this), size());
+    const_iterator p_last(&last_ptr);
+    return p_last;
+  }
+  reference Rope::front()
+  {
+    return (*this)[0];
+  }
+  const_reference Rope::front() const
+  {
+    return (*this)[0];
+  }
+  reference Rope::back()
+  {
+    return (*this)[size()-1];
+  }
+  const_reference Rope::back() const
+  {
+    return (*this)[size()-1];
+  }
+  reference Rope::operator[](size_type pos)
+  {
+    return find_leaf(root, pos)->data[pos];
+  }
+  const_reference Rope::operator[](size_type pos) const
+  {
+    return find_leaf(root, pos)->data[pos];
+  }
+  size_type Rope::size() const
+  {
+    return root->size;
+  }
+  void Rope::clear()
+  {
+    destroy(root);
+    root = new rope_leaf();
+  }
+  bool Rope::empty() const
+  {
+    return root->size == 0;
+  }
+  void Rope::erase(const_iterator pos)
+  {
+    size_type position = pos - this->begin();
+    if (position < size())
+      erase_one(position);
+  }
+  void Rope::erase(const_iterator begin, const_iterator end)
+  {
+    size_type start = begin - this->begin();
+    size_type count = end - begin;
+    for (size_type i = 0; i < count; i++)
+      erase_one(start);
+  }
+  void Rope::insert(const_iterator pos, size_type count, const_reference val)
+  {
+    size_type position = pos - this->begin();
+    if (position > size())
+      return;
+
+    value_type copy = val;
+    for (size_type i = 0; i < count; i++)
+      insert_one(position, copy);
+  }
+  void Rope::insert(const_iterator pos, const_iterator begin, const_iterator end)
+  {
+    size_type position = pos - this->begin();
+    if (position > size() || begin == end)
+      return;
+
+    // the source range may live in this rope, so take a copy before the tree changes shape
+    Vector tmp;
+    tmp.reserve(end - begin);
+    for (; begin != end; ++begin)
+      tmp.push_back(*begin);
+    for (size_type i = 0; i < tmp.size(); i++)
+      insert_one(position + i, tmp[i]);
+  }
+  void Rope::pop_back()
+  {
+    if (empty())
+      return;
+    erase_one(size() - 1);
+  }
+  void Rope::pop_front()
+  {
+    if (empty())
+      return;
+    erase_one(0);
+  }
+  void Rope::push_back(const_reference val)
+  {
+    insert_one(size(), val);
+  }
+  void Rope::push_front(const_reference val)
+  {
+    insert_one(0, val);
+  }
+}  // namespace I2P2
@@ -0,0 +1,121 @@
+#include "../header/I2P2_SPSCQueue.h"
+#include <algorithm>
+
+namespace I2P2
+{
+  SPSCQueue::SPSCQueue(size_type min_capacity)
+  {
+    size_type cap = 1;
+    while (cap < min_capacity)
+      cap <<= 1;
+
+    buffer.reserve(cap);
+    buffer.insert(buffer.end(), cap, value_type(0));
+    slots = &buffer[0];
+    mask = cap - 1;
+
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    cached_head = 0;
+    cached_tail = 0;
+  }
+  size_type SPSCQueue::capacity() const
+  {
+    return mask + 1;
+  }
+  size_type SPSCQueue::size() const
+  {
+    size_type h = head.load(std::memory_order_acquire);
+    size_type t = tail.load(std::memory_order_acquire);
+    return t - h;
+  }
+  bool SPSCQueue::empty() const
+  {
+    return size() == 0;
+  }
+  bool SPSCQueue::push(const_reference val)
+  {
+    size_type t = tail.load(std::memory_order_relaxed);
+
+    if (t - cached_head == capacity())
+    {
+      cached_head = head.load(std::memory_order_acquire);
+      if (t - cached_head == capacity())
+        return false;
+    }
+
+    slots[t & mask] = val;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+  size_type SPSCQueue::push_n(const_pointer src, size_type count)
+  {
+    size_type t = tail.load(std::memory_order_relaxed);
+    size_type free_cnt = capacity() - (t - cached_head);
+
+    if (free_cnt < count)
+    {
+      cached_head = head.load(std::memory_order_acquire);
+      free_cnt = capacity() - (t - cached_head);
+    }
+
+    size_type n = std::min(count, free_cnt);
+    if (n == 0)
+      return 0;
+
+    // at most two contiguous spans: up to the end of the buffer, then from slot 0
+    size_type start = t & mask;
+    size_type first = std::min(n, capacity() - start);
+    std::copy(src, src + first, slots + start);
+    std::copy(src + first, src + n, slots);
+
+    tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+  size_type SPSCQueue::push_n(VectorView src)
+  {
+    return push_n(src.data(), src.size());
+  }
+  bool SPSCQueue::pop(reference val)
+  {
+    size_type h = head.load(std::memory_order_relaxed);
+
+    if (h == cached_tail)
+    {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if (h == cached_tail)
+        return false;
+    }
+
+    val = slots[h & mask];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+  size_type SPSCQueue::pop_n(pointer dst, size_type count)
+  {
+    size_type h = head.load(std::memory_order_relaxed);
+    size_type avail = cached_tail - h;
+
+    if (avail < count)
+    {
+      cached_tail = tail.load(std::memory_order_acquire);
+      avail = cached_tail - h;
+    }
+
+    size_type n = std::min(count, avail);
+    if (n == 0)
+      return 0;
+
+    size_type start = h & mask;
+    size_type first = std::min(n, capacity() - start);
+    std::copy(slots + start, slots + start + first, dst);
+    std::copy(slots, slots + (n - first), dst + first);
+
+    head.store(h + n, std::memory_order_release);
+    return n;
+  }
+  size_type SPSCQueue::pop_n(Span dst)
+  {
+    return pop_n(dst.data(), dst.size());
+  }
+}  // namespace I2P2
@@ -0,0 +1,261 @@
+#include "../header/I2P2_SegmentedVector.h"
+#include "../header/I2P2_Vector.h"
+#include <algorithm>
+
+namespace I2P2
+{
+  namespace
+  {
+    const size_type first_segment = SegmentedVector::first_segment;
+
+    size_type floor_log2(size_type x)
+    {
+#ifdef __GNUC__
+      return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(x);
+#else
+      size_type result = 0;
+      while (x >>= 1)
+        result++;
+      return result;
+#endif
+    }
+    const size_type first_shift = floor_log2(first_segment);
+
+    size_type segment_size(size_type k)
+    {
+      return first_segment << k;
+    }
+    // with t = pos + first_segment, segment k covers t in [first << k, first << (k + 1))
+    void split_index(size_type pos, size_type &k, size_type &offset)
+    {
+      size_type t = pos + first_segment;
+      k = floor_log2(t) - first_shift;
+      offset = t - segment_size(k);
+    }
+  }
+
+  const size_type SegmentedVector::first_segment;
+  const size_type SegmentedVector::max_segments;
+
+  SegmentedVector::~SegmentedVector()
+  {
+    for (size_type k = 0; k < segment_count; k++)
+      operator delete[](segments[k]);
+  }
+  SegmentedVector::SegmentedVector()
+  {
+    segment_count = 0;
+    _size = 0;
+  }
+  SegmentedVector::SegmentedVector(const SegmentedVector &rhs)
+  {
+    segment_count = 0;
+    _size = 0;
+
+    grow_to(rhs.size());
+    for (size_type k = 0; k < rhs.segment_count && _size < rhs.size(); k++)
+    {
+      size_type count = std::min(segment_size(k), rhs.size() - _size);
+      std::copy(rhs.segments[k], rhs.segments[k] + count, segments[k]);
+      _size += count;
+    }
+  }
+  SegmentedVector& SegmentedVector::operator=(const SegmentedVector &rhs)
+  {
+    if (this == &rhs)
+      return *this;
+
+    _size = 0;
+    grow_to(rhs.size());
+    for (size_type k = 0; k < rhs.segment_count && _size < rhs.size(); k++)
+    {
+      size_type count = std::min(segment_size(k), rhs.size() - _size);
+      std::copy(rhs.segments[k], rhs.segments[k] + count, segments[k]);
+      _size += count;
+    }
+    return *this;
+  }
+  void SegmentedVector::add_segment()
+  {
+    size_type count = segment_size(segment_count);
+    segments[segment_count] = static_cast<pointer>(operator new[](count * sizeof(value_type)));
+    segment_count++;
+  }
+  void SegmentedVector::grow_to(size_type count)
+  {
+    while (capacity() < count)
+      add_segment();
+  }
+  pointer SegmentedVector::locate(size_type pos) const
+  {
+    size_type k, offset;
+    split_index(pos, k, offset);
+    return segments[k] + offset;
+  }
+  const_pointer SegmentedVector::chunk(size_type pos, size_type &count) const
+  {
+    size_type k, offset;
+    split_index(pos, k, offset);
+    count = std::min(segment_size(k) - offset, size() - pos);
+    return segments[k] + offset;
+  }
+  iterator SegmentedVector::begin()
+  {
+    index_iterator start_ptr = index_iterator(this, 0);
+    iterator p_start(&start_ptr);
+    return p_start;
+  }
+  const_iterator SegmentedVector::begin() const
+  {
+    index_iterator start_ptr = index_iterator(const_cast<SegmentedVector*>(this), 0);
+    const_iterator p_start(&start_ptr);
+    return p_start;
+  }
+  iterator SegmentedVector::end()
+  {
+    index_iterator last_ptr = index_iterator(this, size());
+    iterator p_last(&last_ptr);
+    return p_last;
+  }
+  const_iterator SegmentedVector::end() const
+  {
+    index_iterator last_ptr = index_iterator(const_cast<SegmentedVector*>(this), size());
+    const_iterator p_last(&last_ptr);
+    return p_last;
+  }
+  reference SegmentedVector::front()
+  {
+    return *segments[0];
+  }
+  const_reference SegmentedVector::front() const
+  {
+    return *segments[0];
+  }
+  reference SegmentedVector::back()
+  {
+    return *locate(size()-1);
+  }
+  const_reference SegmentedVector::back() const
+  {
+    return *locate(size()-1);
+  }
+  reference SegmentedVector::operator[](size_type pos)
+  {
+    return *locate(pos);
+  }
+  const_reference SegmentedVector::operator[](size_type pos) const
+  {
+    return *locate(pos);
+  }
+  size_type SegmentedVector::capacity() const
+  {
+    return first_segment * ((size_type(1) << segment_count) - 1);
+  }
+  size_type SegmentedVector::size() const
+  {
+    return _size;
+  }
+  void SegmentedVector::clear()
+  {
+    _size = 0;
+  }
+  bool SegmentedVector::empty() const
+  {
+    return _size == 0;
+  }
+  void SegmentedVector::erase(const_iterator pos)
+  {
+    size_type position = pos - this->begin();
+    if (position >= size())
+      return;
+
+    for (size_type i = position; i + 1 < size(); i++)
+      *locate(i) = *locate(i + 1);
+    _size--;
+  }
+  void SegmentedVector::erase(const_iterator begin, const_iterator end)
+  {
+    size_type start = begin - this->begin();
+    size_type count = end - begin;
+    if (count == 0)
+      return;
+
+    for (size_type i = start; i + count < size(); i++)
+      *locate(i) = *locate(i + count);
+    _size -= count;
+  }
+  void SegmentedVector::insert(const_iterator pos, size_type count, const_reference val)
+  {
+    size_type position = pos - this->begin();
+    size_type old_size = size();
+    if (count == 0 || position > old_size)
+      return;
+
+    value_type copy = val;
+    grow_to(old_size + count);
+    _size += count;
+    for (size_type i = old_size; i > position; i--)
+      *locate(i - 1 + count) = *locate(i - 1);
+    for (size_type i = 0; i < count; i++)
+      *locate(position + i) = copy;
+  }
+  void SegmentedVector::insert(const_iterator pos, const_iterator begin, const_iterator end)
+  {
+    size_type position = pos - this->begin();
+    size_type old_size = size();
+    if (begin == end || position > old_size)
+      return;
+
+    // the source range may be this container, so copy it out before shifting
+    Vector tmp;
+    tmp.reserve(end - begin);
+    for (; begin != end; ++begin)
+      tmp.push_back(*begin);
+
+    size_type count = tmp.size();
+    grow_to(old_size + count);
+    _size += count;
+    for (size_type i = old_size; i > position; i--)
+      *locate(i - 1 + count) = *locate(i - 1);
+    for (size_type i = 0; i < count; i++)
+      *locate(position + i) = tmp[i];
+  }
+  void SegmentedVector::pop_back()
+  {
+    if (_size != 0)
+      _size--;
+  }
+  void SegmentedVector::pop_front()
+  {
+    if (_size == 0)
+      return;
+    erase(this->begin());
+  }
+  void SegmentedVector::push_back(const_reference val)
+  {
+    if (_size == capacity())
+    {
+      value_type copy = val;
+      add_segment();
+      *locate(_size++) = copy;
+      return;
+    }
+    *locate(_size++) = val;
+  }
+  void SegmentedVector::push_front(const_reference val)
+  {
+    insert(this->begin(), 1, val);
+  }
+  void SegmentedVector::reserve(size_type new_capacity)
+  {
+    grow_to(new_capacity);
+  }
+  void SegmentedVector::shrink_to_fit()
+  {
+    while (segment_count > 0 && first_segment * ((size_type(1) << (segment_count - 1)) - 1) >= size())
+    {
+      segment_count--;
+      operator delete[](segments[segment_count]);
+    }
+  }
+}  // namespace I2P2
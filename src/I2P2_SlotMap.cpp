@@ -0,0 +1,74 @@
+#include "../header/I2P2_SlotMap.h"
+
+namespace I2P2
+{
+  const uint32_t SlotMap::no_slot;
+
+  void SlotMap::release(uint32_t index)
+  {
+    slot &s = _slots[index];
+    // once the generation wraps, reusing the slot could revive handles from long ago, so it retires
+    if (++s.generation == 0)
+      return;
+    s.link = _free;
+    _free = index;
+  }
+
+  slot_handle SlotMap::insert(const_reference val)
+  {
+    value_type copy = val;
+    uint32_t index;
+    if (_free != no_slot)
+    {
+      index = _free;
+      _free = _slots[index].link;
+    }
+    else
+    {
+      index = static_cast<uint32_t>(_slots.size());
+      slot fresh = {0, 0};
+      _slots.push_back(fresh);
+    }
+
+    slot &s = _slots[index];
+    s.generation++;
+    s.link = static_cast<uint32_t>(_values.size());
+    _values.push_back(copy);
+    _owner.push_back(index);
+
+    slot_handle handle = {index, s.generation};
+    return handle;
+  }
+  bool SlotMap::erase(slot_handle handle)
+  {
+    if (!contains(handle))
+      return false;
+
+    uint32_t hole = _slots[handle.index].link;
+    uint32_t last = static_cast<uint32_t>(_values.size() - 1);
+    if (hole != last)
+    {
+      // the last value fills the hole, and its slot follows it
+      _values[hole] = _values[last];
+      _owner[hole] = _owner[last];
+      _slots[_owner[hole]].link = hole;
+    }
+    _values.pop_back();
+    _owner.pop_back();
+    release(handle.index);
+    return true;
+  }
+  void SlotMap::reserve(size_type count)
+  {
+    _values.reserve(count);
+    _owner.reserve(count);
+    _slots.reserve(count);
+  }
+  void SlotMap::clear()
+  {
+    for (uint32_t index : _owner)
+      release(index);
+    _values.clear();
+    _owner.clear();
+  }
+}  // namespace I2P2
@@ -1,4 +1,8 @@
 #include "../header/I2P2_Vector.h"
+#include "../header/I2P2_Span.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
 
 namespace I2P2 {
     Vector::~Vector()
@@ -7,7 +11,10 @@ namespace I2P2 {
         p_begin[i].~value_type();
       
       if (p_begin != nullptr) 
+      {
+        I2P2_STAT(count_free(_stats, capacity() * sizeof(value_type)));
         operator delete[](p_begin);         
+      }
     }
     Vector::Vector()
     {
@@ -17,16 +24,20 @@ namespace I2P2 {
     }
     Vector::Vector(const Vector &rhs)
     {
+      I2P2_LATENCY_SCOPE(latency_copy);
       p_begin = nullptr;
       p_end = nullptr;
       p_last = nullptr;
 
       reserve(rhs.size());
       for (size_type i = 0;i < rhs.size();i++)
-        insert(this->begin()+i, 1, rhs[i]);
+        new (p_begin + i) value_type(rhs.p_begin[i]);
+      p_last = p_begin + rhs.size();
+      I2P2_STAT(count_copied(_stats, rhs.size()));
     }
     Vector& Vector::operator=(const Vector &rhs)
     {
+      I2P2_LATENCY_SCOPE(latency_copy);
       if (this == &rhs) 
         return *this;
 
@@ -37,78 +48,298 @@ namespace I2P2 {
 
       reserve(rhs.size());
       for (size_type i = 0;i < rhs.size();i++)
-        insert(this->begin()+i, 1, rhs[i]);
+        new (p_begin + i) value_type(rhs.p_begin[i]);
+      p_last = p_begin + rhs.size();
+      I2P2_STAT(count_copied(_stats, rhs.size()));
 
       return *this;
     }
-    iterator Vector::begin()
+    Vector::Vector(size_type count)
     {
-      vector_iterator start_ptr = vector_iterator(p_begin);
-      iterator p_start(&start_ptr);
-      return p_start;
+      p_begin = nullptr;
+      p_end = nullptr;
+      p_last = nullptr;
+
+      reserve(count);
+      for (size_type i = 0;i < count;i++)
+        new (p_begin + i) value_type();
+      p_last = p_begin + count;
     }
-    const_iterator Vector::begin() const
+    Vector::Vector(size_type count, const_reference val)
     {
-      vector_iterator start_ptr = vector_iterator(p_begin);
-      const_iterator p_start(&start_ptr);
-      return p_start;
+      p_begin = nullptr;
+      p_end = nullptr;
+      p_last = nullptr;
+
+      reserve(count);
+      for (size_type i = 0;i < count;i++)
+        new (p_begin + i) value_type(val);
+      p_last = p_begin + count;
     }
-    iterator Vector::end()
+    Vector::Vector(const_iterator begin, const_iterator end)
     {
-      vector_iterator last_ptr = vector_iterator(p_last);
-      iterator p_last(&last_ptr);
-      return p_last;
+      p_begin = nullptr;
+      p_end = nullptr;
+      p_last = nullptr;
+
+      size_type count = end - begin;
+      reserve(count);
+      for (size_type i = 0;i < count;i++, ++begin)
+        new (p_begin + i) value_type(*begin);
+      p_last = p_begin + count;
+      I2P2_STAT(count_copied(_stats, count));
     }
-    const_iterator Vector::end() const
+    void Vector::grow(size_type new_size)
     {
-      vector_iterator last_ptr = vector_iterator(p_last);
-      const_iterator p_last(&last_ptr);
-      return p_last;
+      size_type old_capacity = capacity();
+      if (new_size > old_capacity)
+      {
+        if (new_size > old_capacity * 3)
+          reserve(new_size);
+        else
+          reserve(old_capacity * 3);
+      }
     }
-    reference Vector::front()
+    void Vector::reset_storage(size_type new_capacity)
     {
-      return *p_begin;    
+      // the old contents are about to be overwritten, so drop them instead of copying them over
+      for (size_type i = 0;i < size();i++)
+        p_begin[i].~value_type();
+
+      if (p_begin != nullptr)
+      {
+        I2P2_STAT(count_free(_stats, capacity() * sizeof(value_type)));
+        operator delete[](p_begin);
+      }
+
+      p_begin = static_cast<pointer>(operator new[](new_capacity * sizeof(value_type)));
+      p_last = p_begin;
+      p_end = p_begin + new_capacity;
+      I2P2_STAT(count_allocation(_stats, new_capacity * sizeof(value_type)));
+      I2P2_STAT(count_capacity(_stats, new_capacity));
     }
-    const_reference Vector::front() const
+    void Vector::assign(size_type count, const_reference val)
     {
-      return *p_begin;
+      value_type copy = val;
+      if (count > capacity())
+        reset_storage(count);
+
+      size_type old_size = size();
+      for (size_type i = 0;i < count;i++)
+      {
+        if (i < old_size)
+          p_begin[i] = copy;
+        else
+          new (p_begin + i) value_type(copy);
+      }
+      for (size_type i = count;i < old_size;i++)
+        p_begin[i].~value_type();
+      p_last = p_begin + count;
+      I2P2_STAT(count_copied(_stats, count));
     }
-    reference Vector::back()
+    void Vector::assign(const_iterator begin, const_iterator end)
     {
-      return p_begin[size()-1];       
+      size_type count = end - begin;
+      // a range taken from this vector always fits, and copying forward never reads an overwritten slot
+      if (count > capacity())
+        reset_storage(count);
+
+      size_type old_size = size();
+      for (size_type i = 0;i < count;i++, ++begin)
+      {
+        if (i < old_size)
+          p_begin[i] = *begin;
+        else
+          new (p_begin + i) value_type(*begin);
+      }
+      for (size_type i = count;i < old_size;i++)
+        p_begin[i].~value_type();
+      p_last = p_begin + count;
+      I2P2_STAT(count_copied(_stats, count));
     }
-    const_reference Vector::back() const
+    void Vector::resize(size_type count)
     {
-      return p_begin[size()-1];
+      size_type old_size = size();
+      if (count > old_size)
+      {
+        grow(count);
+        for (size_type i = old_size;i < count;i++)
+          new (p_begin + i) value_type();
+      }
+      for (size_type i = count;i < old_size;i++)
+        p_begin[i].~value_type();
+      p_last = p_begin + count;
     }
-    reference Vector::operator[](size_type pos)
+    void Vector::resize(size_type count, const_reference val)
     {
-      return p_begin[pos];
+      size_type old_size = size();
+      if (count > old_size)
+      {
+        value_type copy = val;
+        grow(count);
+        for (size_type i = old_size;i < count;i++)
+          new (p_begin + i) value_type(copy);
+      }
+      for (size_type i = count;i < old_size;i++)
+        p_begin[i].~value_type();
+      p_last = p_begin + count;
     }
-    const_reference Vector::operator[](size_type pos) const
+    void Vector::resize_uninitialized(size_type count)
     {
-      return p_begin[pos];
+      if (count > size())
+        grow(count);
+      p_last = p_begin + count;
     }
-    size_type Vector::capacity() const
+    void Vector::append(const_pointer src, size_type count)
     {
-      return p_end - p_begin;
+      if (count == 0)
+        return;
+
+      // src may point into this vector, so find it again after growing
+      size_type old_size = size();
+      bool inside = src >= p_begin && src < p_last;
+      size_type offset = src - p_begin;
+      grow(old_size + count);
+      if (inside)
+        src = p_begin + offset;
+
+      std::memcpy(p_begin + old_size, src, count * sizeof(value_type));
+      p_last = p_begin + old_size + count;
+      I2P2_STAT(count_copied(_stats, count));
     }
-    size_type Vector::size() const
+    template <class Read>
+    ssize_t Vector::fill_from_fd(size_type count, Read read)
     {
-      return p_last - p_begin;
+      size_type old_size = size();
+      grow(old_size + count);
+
+      char *tail = reinterpret_cast<char *>(p_begin + old_size);
+      size_type wanted = count * sizeof(value_type);
+      size_type got = 0;
+      while (got < wanted)
+      {
+        ssize_t n = read(tail + got, wanted - got, got);
+        if (n < 0 && errno == EINTR)
+          continue;
+        // nothing has arrived, so size() is unchanged and errno is still read()'s
+        if (n < 0 && got == 0)
+          return -1;
+        if (n <= 0)
+          break;
+        got += n;
+      }
+      // the bytes of a partial element stay in the spare capacity right after the last element
+      p_last = p_begin + old_size + got / sizeof(value_type);
+      return static_cast<ssize_t>(got);
     }
-    void Vector::clear()
+    ssize_t Vector::append_from_fd(int fd, size_type count)
     {
-      size_type old_s = size();
-      for(size_type i = 0; i < old_s; i++)
-        pop_back();
+      return fill_from_fd(count, [fd](char *buf, size_type len, size_type) { return read(fd, buf, len); });
     }
-    bool Vector::empty() const
+    ssize_t Vector::append_from_fd(int fd, size_type count, off_t offset)
     {
-      return p_last == p_begin;
+      return fill_from_fd(count, [fd, offset](char *buf, size_type len, size_type done) {
+        return pread(fd, buf, len, offset + static_cast<off_t>(done));
+      });
+    }
+    Vector::Vector(VectorView src)
+    {
+      p_begin = nullptr;
+      p_end = nullptr;
+      p_last = nullptr;
+
+      reserve(src.size());
+      if (src.size() != 0)
+        std::memcpy(p_begin, src.data(), src.size() * sizeof(value_type));
+      p_last = p_begin + src.size();
+      I2P2_STAT(count_copied(_stats, src.size()));
+    }
+    void Vector::assign(VectorView src)
+    {
+      if (src.size() > capacity())
+        reset_storage(src.size());
+
+      // a view of this vector always fits, and memmove copes with the overlap
+      if (src.size() != 0)
+        std::memmove(p_begin, src.data(), src.size() * sizeof(value_type));
+      p_last = p_begin + src.size();
+      I2P2_STAT(count_copied(_stats, src.size()));
+    }
+    void Vector::append(VectorView src)
+    {
+      append(src.data(), src.size());
+    }
+    void Vector::append(StridedView src)
+    {
+      size_type old_size = size();
+      bool inside = src.data() >= p_begin && src.data() < p_last;
+      size_type offset = src.data() - p_begin;
+      grow(old_size + src.size());
+
+      const_pointer from = inside ? p_begin + offset : src.data();
+      for (size_type i = 0;i < src.size();i++)
+        p_begin[old_size + i] = from[i * src.step()];
+      p_last = p_begin + old_size + src.size();
+      I2P2_STAT(count_copied(_stats, src.size()));
+    }
+    void Vector::insert(const_iterator pos, VectorView src)
+    {
+      I2P2_LATENCY_SCOPE(latency_insert);
+      size_type position = pos - this->begin();
+      size_type old_size = size();
+      size_type count = src.size();
+      if (count == 0 || position > old_size)
+        return;
+
+      if (src.data() < p_last && src.data() + count > p_begin)
+      {
+        // shifting the tail would move the source under our feet
+        Vector tmp(src);
+        insert(pos, VectorView(tmp));
+        return;
+      }
+
+      grow(old_size + count);
+      std::memmove(p_begin + position + count, p_begin + position, (old_size - position) * sizeof(value_type));
+      std::memcpy(p_begin + position, src.data(), count * sizeof(value_type));
+      p_last = p_begin + old_size + count;
+      I2P2_STAT(count_moved(_stats, old_size - position));
+      I2P2_STAT(count_copied(_stats, count));
+    }
+    iterator Vector::begin()
+    {
+      vector_iterator start_ptr = vector_iterator(p_begin);
+      iterator p_start(&start_ptr);
+      return p_start;
+    }
+    const_iterator Vector::begin() const
+    {
+      vector_iterator start_ptr = vector_iterator(p_begin);
+      const_iterator p_start(&start_ptr);
+      return p_start;
+    }
+    iterator Vector::end()
+    {
+      vector_iterator last_ptr = vector_iterator(p_last);
+      iterator p_last(&last_ptr);
+      return p_last;
+    }
+    const_iterator Vector::end() const
+    {
+      vector_iterator last_ptr = vector_iterator(p_last);
+      const_iterator p_last(&last_ptr);
+      return p_last;
+    }
+    void Vector::clear()
+    {
+      I2P2_LATENCY_SCOPE(latency_clear);
+      for (size_type i = 0;i < size();i++)
+        p_begin[i].~value_type();
+      p_last = p_begin;
     }
     void Vector::erase(const_iterator pos)
     {
+      I2P2_LATENCY_SCOPE(latency_erase);
       if(pos != this->end())
       {
         size_type position = pos - this->begin();
@@ -121,11 +352,13 @@ namespace I2P2 {
           }
           p_begin[size()-1].~value_type();
           p_last--;
+          I2P2_STAT(count_moved(_stats, size() - position));
         }
       }
     }
     void Vector::erase(const_iterator begin, const_iterator end)
     {
+      I2P2_LATENCY_SCOPE(latency_erase);
       if(begin != end)
       {
         size_type start = begin - this->begin();
@@ -144,11 +377,13 @@ namespace I2P2 {
           for(size_type i = old_size-1; i >= old_size-count; i--)
             p_begin[i].~value_type();
           p_last -= count;
+          I2P2_STAT(count_moved(_stats, old_size - fin));
         }
       }
     }
     void Vector::insert(const_iterator pos, size_type count, const_reference val)
     {
+      I2P2_LATENCY_SCOPE(latency_insert);
       if(count <= 0)
         return;
         
@@ -174,9 +409,12 @@ namespace I2P2 {
         p_begin[i] = p_begin[i-count];
       for(size_type i = 0; i < count; i++)
         p_begin[position+i] = val;
+      I2P2_STAT(count_moved(_stats, old_size - position));
+      I2P2_STAT(count_copied(_stats, count));
     }
     void Vector::insert(const_iterator pos, const_iterator begin, const_iterator end)
     {
+      I2P2_LATENCY_SCOPE(latency_insert);
       if(begin != end)
       {
         size_type position = pos - this->begin(); 
@@ -186,6 +424,7 @@ namespace I2P2 {
 
         size_type inc = 0;
         pointer tmp = new value_type[count+1];
+        I2P2_STAT(count_allocation(_stats, (count + 1) * sizeof(value_type)));
         while(begin != end)
         {
           tmp[inc++] = *begin;
@@ -207,33 +446,33 @@ namespace I2P2 {
           p_begin[i] = p_begin[i-count];
         for(size_type i = 0; i < count; i++)
           p_begin[position+i] = tmp[i];
+        I2P2_STAT(count_moved(_stats, old_size - position));
+        I2P2_STAT(count_copied(_stats, count));
 
         delete [] tmp;
+        I2P2_STAT(count_free(_stats, (count + 1) * sizeof(value_type)));
       }
     }
-    void Vector::pop_back()
-    {
-      erase(this->begin() + size() - 1);
-    }
     void Vector::pop_front()
     {
+      I2P2_LATENCY_SCOPE(latency_pop_front);
       erase(this->begin());
     }
-    void Vector::push_back(const_reference val)
-    {
-      insert(this->end(), 1, val);
-    }
     void Vector::push_front(const_reference val)
     {
+      I2P2_LATENCY_SCOPE(latency_push_front);
       insert(this->begin(), 1, val);
     }
     void Vector::reserve(size_type new_capacity)
     {
+      I2P2_LATENCY_SCOPE(latency_reserve);
       size_type old_capacity = capacity();
       size_type old_size = size();
       if (old_capacity < new_capacity) 
       {
         pointer new_begin(static_cast<pointer>(operator new[](new_capacity * sizeof(value_type))));
+        I2P2_STAT(count_allocation(_stats, new_capacity * sizeof(value_type)));
+        I2P2_STAT(count_capacity(_stats, new_capacity));
         for (size_type i = 0;i < old_size;i++) 
         {
           new (new_begin + i) value_type(p_begin[i]);
@@ -241,7 +480,12 @@ namespace I2P2 {
         }
 
         if (p_begin != nullptr) 
+        {
+          I2P2_STAT(count_free(_stats, old_capacity * sizeof(value_type)));
+          I2P2_STAT(if (old_size != 0) count_reallocation(_stats));
+          I2P2_STAT(count_moved(_stats, old_size));
           operator delete[](p_begin);
+        }
         
         p_begin = new_begin;
         p_last = &p_begin[old_size];
@@ -256,6 +500,7 @@ namespace I2P2 {
       if(old_capacity > old_size)
       {
         pointer new_begin(static_cast<pointer>(operator new[](old_size * sizeof(value_type))));
+        I2P2_STAT(count_allocation(_stats, old_size * sizeof(value_type)));
         for (size_type i = 0;i < old_size;i++) 
         {
           new (new_begin + i) value_type(p_begin[i]);
@@ -263,7 +508,12 @@ namespace I2P2 {
         }
 
         if (p_begin != nullptr) 
+        {
+          I2P2_STAT(count_free(_stats, old_capacity * sizeof(value_type)));
+          I2P2_STAT(if (old_size != 0) count_reallocation(_stats));
+          I2P2_STAT(count_moved(_stats, old_size));
           operator delete[](p_begin);
+        }
         
         p_begin = new_begin;
         p_last = &p_begin[old_size];
@@ -1,4 +1,6 @@
 #include "../header/I2P2_iterator.h"
+#include "../header/I2P2_container.h"
+#include "../header/I2P2_stats.h"
 #include <iostream>
 
 namespace I2P2 
@@ -30,6 +32,7 @@ namespace I2P2
   }
   iterator_impl_base* vector_iterator::clone() const
   {
+    I2P2_STAT(count_iterator_clone());
     return new vector_iterator(vec);
   }
   bool vector_iterator::operator==(const iterator_impl_base &rhs) const
@@ -103,6 +106,7 @@ namespace I2P2
   }
   iterator_impl_base* list_iterator::clone() const
   {
+    I2P2_STAT(count_iterator_clone());
     return new list_iterator(_node); 
   }
   bool list_iterator::operator==(const iterator_impl_base &rhs) const
@@ -250,6 +254,73 @@ namespace I2P2
     return now->data;
   }
 
+  //index_iterator implementation
+  iterator_impl_base& index_iterator::operator++()
+  {
+    _pos++;
+    return *this;
+  }
+  iterator_impl_base& index_iterator::operator--()
+  {
+    _pos--;
+    return *this;
+  }
+  iterator_impl_base& index_iterator::operator+=(difference_type offset)
+  {
+    _pos += offset;
+    return *this;
+  }
+  iterator_impl_base& index_iterator::operator-=(difference_type offset)
+  {
+    _pos -= offset;
+    return *this;
+  }
+  iterator_impl_base* index_iterator::clone() const
+  {
+    I2P2_STAT(count_iterator_clone());
+    return new index_iterator(_con, _pos);
+  }
+  bool index_iterator::operator==(const iterator_impl_base &rhs) const
+  {
+    return _pos == rhs.index_ref();
+  }
+  bool index_iterator::operator!=(const iterator_impl_base &rhs) const
+  {
+    return _pos != rhs.index_ref();
+  }
+  bool index_iterator::operator<(const iterator_impl_base &rhs) const
+  {
+    return _pos < rhs.index_ref();
+  }
+  bool index_iterator::operator>(const iterator_impl_base &rhs) const
+  {
+    return _pos > rhs.index_ref();
+  }
+  bool index_iterator::operator<=(const iterator_impl_base &rhs) const
+  {
+    return _pos <= rhs.index_ref();
+  }
+  bool index_iterator::operator>=(const iterator_impl_base &rhs) const
+  {
+    return _pos >= rhs.index_ref();
+  }
+  difference_type index_iterator::operator-(const iterator_impl_base &rhs) const
+  {
+    return _pos - rhs.index_ref();
+  }
+  pointer index_iterator::operator->() const
+  {
+    return &(*_con)[_pos];
+  }
+  reference index_iterator::operator*() const
+  {
+    return (*_con)[_pos];
+  }
+  reference index_iterator::operator[](difference_type offset) const
+  {
+    return (*_con)[_pos + offset];
+  }
+
   //const_iterator implementation
   const_iterator::~const_iterator() 
   {
@@ -266,7 +337,12 @@ namespace I2P2
   }
   const_iterator& const_iterator::operator=(const const_iterator &rhs)
   {
-    this->p_ = rhs.p_->clone();
+    if (this == &rhs)
+      return *this;
+
+    iterator_impl_base *p = rhs.p_->clone();
+    delete p_;
+    this->p_ = p;
     return *this;
   }
   const_iterator& const_iterator::operator++()
@@ -0,0 +1,208 @@
+#include "../header/I2P2_latency.h"
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+namespace I2P2
+{
+  const char *const latency_op_names[latency_op_cnt] = {
+    "push_back", "push_front", "pop_back", "pop_front", "insert", "erase", "reserve", "clear", "copy"
+  };
+
+  int latency_histogram::bucket_of(uint64_t ns)
+  {
+    if (ns < static_cast<uint64_t>(sub_bucket_cnt))
+      return static_cast<int>(ns);
+
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - sub_bucket_bits;
+    // top is in [sub_bucket_cnt, 2 * sub_bucket_cnt)
+    int top = static_cast<int>(ns >> shift);
+    return (shift + 1) * sub_bucket_cnt + (top - sub_bucket_cnt);
+  }
+  uint64_t latency_histogram::bucket_top(int bucket)
+  {
+    if (bucket < sub_bucket_cnt)
+      return bucket;
+
+    int shift = bucket / sub_bucket_cnt - 1;
+    uint64_t top = sub_bucket_cnt + bucket % sub_bucket_cnt;
+    // wraps to UINT64_MAX for the last bucket
+    return ((top + 1) << shift) - 1;
+  }
+
+  latency_histogram::latency_histogram() : _counts(), _count(0), _max(0) {}
+  void latency_histogram::record(uint64_t ns)
+  {
+    add(bucket_of(ns), 1);
+    raise_max(ns);
+  }
+  void latency_histogram::add(int bucket, uint64_t count)
+  {
+    _counts[bucket] += count;
+    _count += count;
+  }
+  void latency_histogram::raise_max(uint64_t ns)
+  {
+    _max = std::max(_max, ns);
+  }
+  void latency_histogram::merge(const latency_histogram &rhs)
+  {
+    for (int i = 0; i < bucket_cnt; i++)
+      _counts[i] += rhs._counts[i];
+    _count += rhs._count;
+    _max = std::max(_max, rhs._max);
+  }
+  uint64_t latency_histogram::percentile(double q) const
+  {
+    if (_count == 0)
+      return 0;
+
+    uint64_t rank = static_cast<uint64_t>(q * _count + 0.999999);
+    if (rank < 1)
+      rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < bucket_cnt; i++)
+    {
+      seen += _counts[i];
+      if (seen >= rank)
+        return std::min(bucket_top(i), _max);
+    }
+    return _max;
+  }
+
+  namespace
+  {
+    // one thread's histograms; only the owner writes, readers load concurrently
+    struct thread_histograms
+    {
+      std::atomic<uint64_t> counts[latency_op_cnt][latency_histogram::bucket_cnt];
+      std::atomic<uint64_t> max[latency_op_cnt];
+
+      thread_histograms()
+      {
+        for (int op = 0; op < latency_op_cnt; op++)
+        {
+          for (int i = 0; i < latency_histogram::bucket_cnt; i++)
+            counts[op][i].store(0, std::memory_order_relaxed);
+          max[op].store(0, std::memory_order_relaxed);
+        }
+      }
+      void merge_into(latency_op op, latency_histogram &out) const
+      {
+        for (int i = 0; i < latency_histogram::bucket_cnt; i++)
+        {
+          uint64_t n = counts[op][i].load(std::memory_order_relaxed);
+          if (n != 0)
+            out.add(i, n);
+        }
+        out.raise_max(max[op].load(std::memory_order_relaxed));
+      }
+    };
+
+    // threads register on their first sample and fold into retired when they exit
+    struct registry
+    {
+      std::mutex lock;
+      std::vector<thread_histograms *> live;
+      latency_histogram retired[latency_op_cnt];
+    };
+    // never destroyed: threads may still exit after static destructors have run
+    registry &the_registry()
+    {
+      static registry *reg = new registry;
+      return *reg;
+    }
+
+    struct thread_slot
+    {
+      thread_histograms *hist = nullptr;
+
+      thread_histograms &get()
+      {
+        if (hist == nullptr)
+        {
+          hist = new thread_histograms;
+          registry &reg = the_registry();
+          std::lock_guard<std::mutex> guard(reg.lock);
+          reg.live.push_back(hist);
+        }
+        return *hist;
+      }
+      ~thread_slot()
+      {
+        if (hist == nullptr)
+          return;
+
+        registry &reg = the_registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        for (int op = 0; op < latency_op_cnt; op++)
+          hist->merge_into(static_cast<latency_op>(op), reg.retired[op]);
+        reg.live.erase(std::find(reg.live.begin(), reg.live.end(), hist));
+        delete hist;
+        hist = nullptr;
+      }
+    };
+    thread_local thread_slot slot;
+  }
+
+  void record_latency(latency_op op, uint64_t ns)
+  {
+    thread_histograms &hist = slot.get();
+    std::atomic<uint64_t> &bucket = hist.counts[op][latency_histogram::bucket_of(ns)];
+    // single writer: a plain load and store, no read-modify-write
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (ns > hist.max[op].load(std::memory_order_relaxed))
+      hist.max[op].store(ns, std::memory_order_relaxed);
+  }
+
+  latency_histogram latency_snapshot(latency_op op)
+  {
+    registry &reg = the_registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    latency_histogram merged(reg.retired[op]);
+    for (thread_histograms *hist : reg.live)
+      hist->merge_into(op, merged);
+    return merged;
+  }
+  latency_report latency_summary(latency_op op)
+  {
+    latency_histogram merged = latency_snapshot(op);
+    latency_report report;
+    report.count = merged.count();
+    report.p50 = merged.percentile(0.5);
+    report.p99 = merged.percentile(0.99);
+    report.p999 = merged.percentile(0.999);
+    report.max = merged.max();
+    return report;
+  }
+  void reset_latency()
+  {
+    registry &reg = the_registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (int op = 0; op < latency_op_cnt; op++)
+    {
+      reg.retired[op] = latency_histogram();
+      for (thread_histograms *hist : reg.live)
+      {
+        for (int i = 0; i < latency_histogram::bucket_cnt; i++)
+          hist->counts[op][i].store(0, std::memory_order_relaxed);
+        hist->max[op].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+  void print_latency(FILE *out)
+  {
+    for (int op = 0; op < latency_op_cnt; op++)
+    {
+      latency_report report = latency_summary(static_cast<latency_op>(op));
+      if (report.count == 0)
+        continue;
+      std::fprintf(out, "%s %llu %llu %llu %llu %llu\n", latency_op_names[op],
+                   static_cast<unsigned long long>(report.count), static_cast<unsigned long long>(report.p50),
+                   static_cast<unsigned long long>(report.p99), static_cast<unsigned long long>(report.p999),
+                   static_cast<unsigned long long>(report.max));
+    }
+  }
+}  // namespace I2P2
@@ -0,0 +1,133 @@
+#include "../header/I2P2_stats.h"
+#include <atomic>
+#include <string>
+
+namespace I2P2
+{
+  namespace
+  {
+    struct global_counters
+    {
+      std::atomic<uint64_t> allocations;
+      std::atomic<uint64_t> frees;
+      std::atomic<uint64_t> bytes_allocated;
+      std::atomic<uint64_t> bytes_freed;
+      std::atomic<uint64_t> reallocations;
+      std::atomic<uint64_t> elements_moved;
+      std::atomic<uint64_t> elements_copied;
+      std::atomic<uint64_t> peak_capacity;
+      std::atomic<uint64_t> iterator_clones;
+    };
+    // zero-initialized as a static, before any container can run
+    global_counters global;
+
+    void add(std::atomic<uint64_t> &counter, uint64_t value)
+    {
+      counter.fetch_add(value, std::memory_order_relaxed);
+    }
+  }
+
+  void count_allocation(alloc_stats &stats, size_type bytes)
+  {
+    stats.allocations++;
+    stats.bytes_allocated += bytes;
+    add(global.allocations, 1);
+    add(global.bytes_allocated, bytes);
+  }
+  void count_free(alloc_stats &stats, size_type bytes)
+  {
+    stats.frees++;
+    stats.bytes_freed += bytes;
+    add(global.frees, 1);
+    add(global.bytes_freed, bytes);
+  }
+  void count_handover(alloc_stats &from, alloc_stats &to, size_type bytes)
+  {
+    from.allocations--;
+    from.bytes_allocated -= bytes;
+    to.allocations++;
+    to.bytes_allocated += bytes;
+  }
+  void count_reallocation(alloc_stats &stats)
+  {
+    stats.reallocations++;
+    add(global.reallocations, 1);
+  }
+  void count_moved(alloc_stats &stats, size_type count)
+  {
+    stats.elements_moved += count;
+    add(global.elements_moved, count);
+  }
+  void count_copied(alloc_stats &stats, size_type count)
+  {
+    stats.elements_copied += count;
+    add(global.elements_copied, count);
+  }
+  void count_capacity(alloc_stats &stats, size_type capacity)
+  {
+    if (capacity > stats.peak_capacity)
+      stats.peak_capacity = capacity;
+
+    uint64_t peak = global.peak_capacity.load(std::memory_order_relaxed);
+    while (capacity > peak && !global.peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed))
+      ;
+  }
+  void count_iterator_clone()
+  {
+    add(global.iterator_clones, 1);
+  }
+
+  alloc_stats global_stats()
+  {
+    alloc_stats stats;
+    stats.allocations = global.allocations.load(std::memory_order_relaxed);
+    stats.frees = global.frees.load(std::memory_order_relaxed);
+    stats.bytes_allocated = global.bytes_allocated.load(std::memory_order_relaxed);
+    stats.bytes_freed = global.bytes_freed.load(std::memory_order_relaxed);
+    stats.reallocations = global.reallocations.load(std::memory_order_relaxed);
+    stats.elements_moved = global.elements_moved.load(std::memory_order_relaxed);
+    stats.elements_copied = global.elements_copied.load(std::memory_order_relaxed);
+    stats.peak_capacity = global.peak_capacity.load(std::memory_order_relaxed);
+    stats.iterator_clones = global.iterator_clones.load(std::memory_order_relaxed);
+    return stats;
+  }
+  void reset_global_stats()
+  {
+    global.allocations.store(0, std::memory_order_relaxed);
+    global.frees.store(0, std::memory_order_relaxed);
+    global.bytes_allocated.store(0, std::memory_order_relaxed);
+    global.bytes_freed.store(0, std::memory_order_relaxed);
+    global.reallocations.store(0, std::memory_order_relaxed);
+    global.elements_moved.store(0, std::memory_order_relaxed);
+    global.elements_copied.store(0, std::memory_order_relaxed);
+    global.peak_capacity.store(0, std::memory_order_relaxed);
+    global.iterator_clones.store(0, std::memory_order_relaxed);
+  }
+
+  void dump_stats(const alloc_stats &stats, const char *prefix, stats_emitter emit, void *ctx)
+  {
+    const struct
+    {
+      const char *name;
+      uint64_t value;
+    } fields[] = {
+      {"allocations", stats.allocations},
+      {"frees", stats.frees},
+      {"bytes_allocated", stats.bytes_allocated},
+      {"bytes_freed", stats.bytes_freed},
+      {"reallocations", stats.reallocations},
+      {"elements_moved", stats.elements_moved},
+      {"elements_copied", stats.elements_copied},
+      {"peak_capacity", stats.peak_capacity},
+      {"iterator_clones", stats.iterator_clones},
+    };
+    for (const auto &field : fields)
+      emit((std::string(prefix) + "." + field.name).c_str(), field.value, ctx);
+  }
+  void print_stats(const alloc_stats &stats, const char *prefix, FILE *out)
+  {
+    dump_stats(stats, prefix, [](const char *name, uint64_t value, void *ctx) {
+      std::fprintf(static_cast<FILE *>(ctx), "%s %llu\n", name, static_cast<unsigned long long>(value));
+    }, out);
+  }
+}  // namespace I2P2
@@ -1,12 +1,26 @@
 #include <list>
+#include <map>
+#include <set>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <chrono>
 #include <memory>
 #include <random>
+#include <thread>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
 #include <utility>
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 #include <type_traits>
 
 #include "../header/I2P2_def.h"
@@ -14,6 +28,28 @@
 #include "../header/I2P2_iterator.h"
 #include "../header/I2P2_List.h"
 #include "../header/I2P2_Vector.h"
+#include "../header/I2P2_CowVector.h"
+#include "../header/I2P2_PersistentVector.h"
+#include "../header/I2P2_Rope.h"
+#include "../header/I2P2_GapBuffer.h"
+#include "../header/I2P2_SegmentedVector.h"
+#include "../header/I2P2_static_container.h"
+#include "../header/I2P2_StaticVector.h"
+#include "../header/I2P2_Span.h"
+#include "../header/I2P2_SPSCQueue.h"
+#include "../header/I2P2_ConcurrentList.h"
+#include "../header/I2P2_trace.h"
+#include "../header/I2P2_stats.h"
+#include "../header/I2P2_latency.h"
+#include "../header/I2P2_FlatSet.h"
+#include "../header/I2P2_FlatMap.h"
+#include "../header/I2P2_HashSet.h"
+#include "../header/I2P2_HashMap.h"
+#include "../header/I2P2_LRUCache.h"
+#include "../header/I2P2_PriorityQueue.h"
+#include "../header/I2P2_SlotMap.h"
+#include "../header/I2P2_PackedVector.h"
+#include "../header/I2P2_EytzingerIndex.h"
 
 namespace I2P2_test {
 const size_t insert_cnt(20);
@@ -21,6 +57,7 @@ const unsigned long op_test_cnt(1 << 20);
 const auto arithmetic_range(255);
 
 thread_local std::mt19937_64 mt(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+void seed(unsigned long long value) { mt.seed(value); }
 std::remove_cv<decltype(arithmetic_range)>::type gen() {
   std::uniform_int_distribution<std::remove_cv<decltype(arithmetic_range)>::type> uniform(0, arithmetic_range);
   return uniform(mt);
@@ -48,9 +85,17 @@ void check_iterator_(Args &&... args) {
 struct no_tag {};
 struct yes_tag {};
 
+// set for the workers of fuzz(): failures are counted and tagged with the worker's seed
+thread_local unsigned long failures(0);
+thread_local std::string failure_tag;
+
 bool check(bool correct, const char *message = "fail") {
   if (correct) ;
-  else std::cerr << message << '\n';
+  else {
+    ++failures;
+    // one write per line, so lines from parallel workers do not interleave
+    std::cerr << (failure_tag + message + '\n');
+  }
   return correct;
 }
 
@@ -638,6 +683,13 @@ void check_hierarchy() {
 #ifdef TEST_VECTOR
   using container_base_is_Vector_base = std::enable_if<std::is_base_of<I2P2::container_base, I2P2::Vector>::value>::type;
 #endif
+#ifdef TEST_STATIC_VECTOR
+  using StaticVector_has_static_base = std::enable_if<std::is_base_of<
+    I2P2::static_randomaccess_container<I2P2::StaticVector<1>>, I2P2::StaticVector<1>>::value>::type;
+  using StaticVector_has_no_vtable = std::enable_if<!std::is_polymorphic<I2P2::StaticVector<1>>::value>::type;
+  using adapter_is_randomaccess = std::enable_if<std::is_base_of<
+    I2P2::randomaccess_container, I2P2::randomaccess_adapter<I2P2::StaticVector<1>>>::value>::type;
+#endif
 }
 
 void check_iterator() {
@@ -760,9 +812,9 @@ void check_list() {
 }
 #endif
 
-#ifdef TEST_VECTOR
-void check_vector() {
-  using test_type = I2P2::Vector;
+#if defined(TEST_VECTOR) || defined(TEST_COW_VECTOR)
+template <class test_type>
+void check_vector_() {
   using std_type = std::vector<I2P2::value_type>;
   using CheckAfter = no_tag;
   using RandomIter = yes_tag;
@@ -874,4 +926,1900 @@ void check_vector() {
   }
 }
 #endif
+
+#ifdef TEST_VECTOR
+void check_vector() {
+  check_vector_<I2P2::Vector>();
+
+  // popping an empty vector leaves it empty, as the out-of-line pop_back did
+  I2P2::Vector e;
+  e.pop_back();
+  e.push_back(gen());
+  e.pop_back();
+  e.pop_back();
+  check(e.empty() && e.size() == 0, "pop_back on an empty vector changed its size");
+
+  // sizing: constructors, assign and resize against std::vector
+  std::uniform_int_distribution<> mode(0, 6);
+  std::uniform_int_distribution<size_t> size_gen(0, insert_cnt * 4);
+  I2P2::Vector c;
+  std::vector<I2P2::value_type> s;
+  for (unsigned long i(0); i != (op_test_cnt >> 4); ++i) {
+    const auto n(size_gen(mt));
+    const auto val(gen());
+    switch (mode(mt)) {
+      case 0: {
+        I2P2::Vector tmp(n, val);
+        check(tmp.capacity() == n, "sized constructor did not allocate exactly once");
+        c = tmp;
+        s.assign(n, val);
+        break;
+      }
+      case 1: {
+        const I2P2::Vector &src(c);
+        I2P2::Vector tmp(src.begin(), src.end());
+        check(tmp.capacity() == s.size(), "range constructor did not allocate exactly once");
+        c = tmp;
+        break;
+      }
+      case 2:
+        c.assign(n, val);
+        s.assign(n, val);
+        break;
+      case 3: {
+        // assigning a subrange of itself must read every source element before overwriting it
+        std::uniform_int_distribution<size_t> pos_gen(0, s.size());
+        auto begin(pos_gen(mt));
+        auto end(pos_gen(mt));
+        if (begin > end) std::swap(begin, end);
+        c.assign(as_const(c).begin() + begin, as_const(c).begin() + end);
+        s = std::vector<I2P2::value_type>(s.begin() + begin, s.begin() + end);
+        break;
+      }
+      case 4:
+        if (mt() & 1) c.resize(n), s.resize(n);
+        else c.resize(n, val), s.resize(n, val);
+        break;
+      case 5: {
+        const auto old_size(s.size());
+        c.resize_uninitialized(old_size + n);
+        s.resize(old_size + n);
+        for (size_t j(old_size); j != s.size(); ++j) c.data()[j] = s[j] = gen();
+        break;
+      }
+      case 6: {
+        I2P2::Vector tmp(n);
+        check(tmp.size() == n && std::count(as_const(tmp).data(), as_const(tmp).data() + n, I2P2::value_type()) ==
+              static_cast<std::ptrdiff_t>(n), "sized constructor did not value-initialize");
+        break;
+      }
+      default:
+        assert(false);
+    }
+    if (!check(c.size() == s.size() && std::equal(s.begin(), s.end(), as_const(c).data()),
+               "content of vector is not equal after resize or assign")) return;
+  }
+  const auto capacity(c.capacity());
+  c.resize(capacity / 2);
+  c.resize(capacity);
+  check(c.capacity() == capacity, "resize within the capacity reallocated");
+
+  // bulk append from memory, including a range of the vector itself
+  I2P2::Vector a;
+  std::vector<I2P2::value_type> expect;
+  for (size_t i(0); i != insert_cnt; ++i) {
+    std::vector<I2P2::value_type> chunk(size_gen(mt));
+    for (auto &val : chunk) val = gen();
+    a.append(chunk.data(), chunk.size());
+    expect.insert(expect.end(), chunk.begin(), chunk.end());
+    const auto half(a.size() / 2);
+    a.append(as_const(a).data() + half, a.size() - half);
+    const std::vector<I2P2::value_type> tail(expect.begin() + half, expect.end());
+    expect.insert(expect.end(), tail.begin(), tail.end());
+  }
+  check(a.size() == expect.size() && std::equal(expect.begin(), expect.end(), as_const(a).data()),
+        "append from a buffer is not equal");
+
+  // round trip through a pipe bigger than its kernel buffer, then pread the same bytes from a file
+  int fds[2];
+  if (!check(pipe(fds) == 0, "pipe failed")) return;
+  std::thread writer([&a, &fds]() {
+    const char *p(reinterpret_cast<const char *>(as_const(a).data()));
+    size_t left(a.size() * sizeof(I2P2::value_type));
+    while (left) {
+      const auto n(write(fds[1], p, left));
+      if (n <= 0) break;
+      p += n;
+      left -= n;
+    }
+    close(fds[1]);
+  });
+  I2P2::Vector b;
+  b.push_back(gen());
+  const auto got(b.append_from_fd(fds[0], a.size() + 1));
+  writer.join();
+  close(fds[0]);
+  check(got == static_cast<ssize_t>(a.size() * sizeof(I2P2::value_type)) && b.size() == a.size() + 1 &&
+            std::equal(expect.begin(), expect.end(), as_const(b).data() + 1),
+        "append_from_fd through a pipe is not equal");
+  errno = 0;
+  check(b.append_from_fd(-1, 4) == -1 && errno == EBADF && b.size() == a.size() + 1,
+        "append_from_fd on a bad descriptor did not fail cleanly");
+
+  FILE *file(std::tmpfile());
+  if (!check(file != nullptr, "tmpfile failed")) return;
+  std::fwrite(as_const(a).data(), sizeof(I2P2::value_type), a.size(), file);
+  std::fflush(file);
+  I2P2::Vector d;
+  const auto skip(a.size() / 3);
+  const auto read_cnt(d.append_from_fd(fileno(file), a.size(), skip * sizeof(I2P2::value_type)));
+  check(read_cnt == static_cast<ssize_t>((a.size() - skip) * sizeof(I2P2::value_type)) &&
+            std::equal(expect.begin() + skip, expect.end(), as_const(d).data()),
+        "append_from_fd with an offset is not equal");
+
+  // the file ends partway into the second element: the whole one is appended, the rest left past the end
+  const size_t bytes(a.size() * sizeof(I2P2::value_type));
+  const size_t before(d.size());
+  const auto tail_cnt(d.append_from_fd(fileno(file), 2, bytes - 2 * sizeof(I2P2::value_type) + 1));
+  std::fclose(file);
+  check(tail_cnt == static_cast<ssize_t>(2 * sizeof(I2P2::value_type) - 1) &&
+            d.size() == before + tail_cnt / sizeof(I2P2::value_type) &&
+            std::memcmp(as_const(d).data() + before, reinterpret_cast<const char *>(as_const(a).data()) + bytes - tail_cnt,
+                        tail_cnt) == 0,
+        "append_from_fd lost the bytes of a partial element");
+}
+#endif
+
+#ifdef TEST_COW_VECTOR
+void check_cow_vector() {
+  I2P2::CowVector a;
+  for (size_t i(0); i != insert_cnt; ++i) a.push_back(gen());
+  const I2P2::CowVector b(a);
+  check(a.shared() && b.shared(), "copy does not share the buffer");
+  check(&b[0] == &as_const(a)[0], "shared copies do not read the same memory");
+  a[0] = b[0];
+  check(!a.shared() && !b.shared(), "mutable access does not detach the copy");
+  const I2P2::CowVector c(a);
+  check(!c.shared() && &c[0] != &as_const(a)[0], "copy shares a buffer that handed out mutable references");
+  I2P2::CowVector d(b);
+  d.push_back(gen());
+  check(!d.shared() && !b.shared(), "mutation does not detach the copy");
+  check(std::equal(b.begin(), b.end(), as_const(d).begin()) && d.size() == b.size() + 1, "detached copy lost elements");
+  d = b;
+  d.clear();
+  check(d.empty() && b.size() == insert_cnt, "clear of a shared copy touched the other copy");
+  check_vector_<I2P2::CowVector>();
+}
+#endif
+
+#ifdef TEST_SPSC_QUEUE
+void check_spsc_queue() {
+  const unsigned long total(op_test_cnt);
+  std::uniform_int_distribution<size_t> cap_gen(1, 1 << 10);
+  I2P2::SPSCQueue q(cap_gen(mt));
+  check(q.capacity() && !(q.capacity() & (q.capacity() - 1)), "capacity is not a power of two");
+  check(q.empty(), "new queue is not empty");
+
+  std::thread producer([&q, total]() {
+    std::mt19937_64 rng(total);
+    I2P2::value_type batch[insert_cnt];
+    unsigned long sent(0);
+    while (sent != total) {
+      const size_t want(std::min<unsigned long>(rng() % insert_cnt + 1, total - sent));
+      if (want == 1) {
+        if (q.push(I2P2::value_type(sent % arithmetic_range))) ++sent;
+        continue;
+      }
+      for (size_t i(0); i != want; ++i) batch[i] = I2P2::value_type((sent + i) % arithmetic_range);
+      sent += q.push_n(batch, want);
+    }
+  });
+
+  I2P2::value_type batch[insert_cnt];
+  unsigned long received(0);
+  bool result(true);
+  while (received != total) {
+    if (mt() & 1) {
+      I2P2::value_type val;
+      if (!q.pop(val)) continue;
+      if (result) result = check(val == I2P2::value_type(received % arithmetic_range), "pop order is not FIFO");
+      ++received;
+      continue;
+    }
+    const auto got(q.pop_n(batch, insert_cnt));
+    for (size_t i(0); i != got; ++i, ++received)
+      if (result) result = check(batch[i] == I2P2::value_type(received % arithmetic_range), "pop_n order is not FIFO");
+  }
+  producer.join();
+  check(q.empty(), "queue is not empty after draining");
+}
+#endif
+
+#ifdef TEST_CONCURRENT_LIST
+void check_concurrent_list() {
+  const unsigned workers(4);
+  const unsigned long per_worker(op_test_cnt / 16);
+  I2P2::ConcurrentList lst;
+  std::vector<long> alive(workers);
+  std::atomic<bool> done(false);
+
+  // each worker only erases handles it created, so its handles never dangle
+  std::vector<std::thread> threads;
+  for (unsigned w(0); w != workers; ++w)
+    threads.push_back(std::thread([&lst, &alive, w, per_worker]() {
+      std::mt19937_64 rng(w);
+      std::vector<I2P2::ConcurrentList::handle> own;
+      for (unsigned long i(0); i != per_worker; ++i) {
+        const auto val(I2P2::value_type(rng() % arithmetic_range));
+        const auto pick(own.empty() ? 0 : rng() % own.size());
+        switch (own.empty() ? rng() % 2 : rng() % 5) {
+          case 0: own.push_back(lst.push_back(val)); break;
+          case 1: own.push_back(lst.push_front(val)); break;
+          case 2: own.push_back(lst.insert_after(own[pick], val)); break;
+          case 3: own.push_back(lst.insert_before(own[pick], val)); break;
+          case 4:
+            check(lst.erase(own[pick]), "erase of a live handle failed");
+            own[pick] = own.back();
+            own.pop_back();
+            break;
+          default:
+            assert(false);
+        }
+        check(own.empty() || own.back() != nullptr, "insert next to a live handle failed");
+      }
+      alive[w] = own.size();
+    }));
+  std::thread reader([&lst, &done]() {
+    while (!done.load()) {
+      size_t visited(0);
+      lst.for_each([&visited](I2P2::value_type) { ++visited; });
+    }
+  });
+  for (auto &t : threads) t.join();
+  done.store(true);
+  reader.join();
+
+  size_t expected(0);
+  for (auto n : alive) expected += n;
+  size_t visited(0);
+  lst.for_each([&visited](I2P2::value_type) { ++visited; });
+  check(lst.size() == expected, "size is not equal to live insertions");
+  check(visited == expected, "iteration does not visit every live node");
+
+  I2P2::value_type val;
+  size_t popped(0);
+  while (popped != expected / 2 && lst.pop_back(val)) ++popped;
+  while (lst.pop_front(val)) ++popped;
+  check(popped == expected && lst.empty(), "pop does not drain the list");
+
+  // pins that always overlap, so the list is never without one, must not hold memory back
+  std::unique_ptr<I2P2::ConcurrentList::pin> held(new I2P2::ConcurrentList::pin(lst));
+  size_t most_retired(0);
+  for (unsigned long i(0); i != per_worker; ++i) {
+    std::unique_ptr<I2P2::ConcurrentList::pin> next(new I2P2::ConcurrentList::pin(lst));
+    held = std::move(next);
+    lst.erase(lst.push_back(gen()));
+    most_retired = std::max<size_t>(most_retired, lst.retired_count());
+  }
+  held.reset();
+  check(most_retired < 16, "overlapping pins keep erased nodes from being freed");
+}
+#endif
+
+#ifdef TEST_PERSISTENT_VECTOR
+void check_persistent_vector() {
+  using test_type = I2P2::PersistentVector;
+  using std_type = std::vector<I2P2::value_type>;
+  const size_t versions(8);
+  std::vector<test_type> usr(versions);
+  std::vector<std_type> stdc(versions);
+  std::uniform_int_distribution<> mode(0, 9);
+  std::uniform_int_distribution<size_t> which(0, versions - 1);
+  auto same([](const test_type &c, const std_type &s) {
+    std_type flat;
+    c.for_each([&flat](I2P2::value_type val) { flat.push_back(val); });
+    bool result(check(c.size() == s.size() && c.empty() == s.empty(), "size of version is not equal"));
+    result &= check(flat == s, "content of version is not equal");
+    if (s.size()) {
+      std::uniform_int_distribution<size_t> pos_gen(0, s.size() - 1);
+      const auto pos(pos_gen(mt));
+      result &= check(c[pos] == s[pos], "your[x] is not equal to std[x]");
+      result &= check(c.front() == s.front() && c.back() == s.back(), "front or back is not equal");
+    }
+    return result;
+  });
+  for (unsigned long i(0); i != (op_test_cnt >> 4); ++i) {
+    const auto dst(which(mt));
+    const auto src(which(mt));
+    switch (mode(mt)) {
+      case 0:
+      case 1:
+      case 2: {
+        const auto val(gen());
+        usr[dst] = usr[src].push_back(val);
+        stdc[dst] = stdc[src];
+        stdc[dst].push_back(val);
+        break;
+      }
+      case 3:
+      case 4:
+        if (stdc[src].size()) {
+          std::uniform_int_distribution<size_t> pos_gen(0, stdc[src].size() - 1);
+          const auto pos(pos_gen(mt));
+          const auto val(gen());
+          usr[dst] = usr[src].set(pos, val);
+          stdc[dst] = stdc[src];
+          stdc[dst][pos] = val;
+        }
+        break;
+      case 5:
+        if (stdc[dst].size() + stdc[src].size() < (1 << 16)) {
+          usr[dst] = usr[dst].concat(usr[src]);
+          stdc[dst].insert(stdc[dst].end(), stdc[src].begin(), stdc[src].end());
+        }
+        break;
+      case 6:
+      case 7: {
+        std::uniform_int_distribution<size_t> pos_gen(0, stdc[src].size());
+        auto begin(pos_gen(mt));
+        auto end(pos_gen(mt));
+        if (begin > end) std::swap(begin, end);
+        usr[dst] = usr[src].slice(begin, end);
+        stdc[dst].assign(stdc[src].begin() + begin, stdc[src].begin() + end);
+        break;
+      }
+      case 8: {
+        I2P2::PersistentVector::transient builder(usr[src]);
+        stdc[dst] = stdc[src];
+        std::uniform_int_distribution<size_t> cnt_gen(0, I2P2::PersistentVector::leaf_capacity * 3);
+        for (auto cnt(cnt_gen(mt)); cnt; --cnt) {
+          const auto val(gen());
+          builder.push_back(val);
+          stdc[dst].push_back(val);
+          std::uniform_int_distribution<size_t> pos_gen(0, stdc[dst].size() - 1);
+          const auto pos(pos_gen(mt));
+          builder.set(pos, val);
+          stdc[dst][pos] = val;
+          check(builder[pos] == val && builder.size() == stdc[dst].size(), "transient is not equal");
+        }
+        usr[dst] = builder.persistent();
+        break;
+      }
+      case 9: {
+        I2P2::Vector vec(usr[src].to_vector());
+        usr[dst] = test_type(vec);
+        stdc[dst] = stdc[src];
+        break;
+      }
+      default:
+        assert(false);
+    }
+    same(usr[dst], stdc[dst]);
+    same(usr[src], stdc[src]);
+  }
+  for (size_t v(0); v != versions; ++v) same(usr[v], stdc[v]);
+
+  // a long transient build, appending chunks in place, with snapshots taken along the way
+  I2P2::PersistentVector::transient builder(usr[0]);
+  std_type built(stdc[0]);
+  std::vector<test_type> snaps;
+  std::vector<std_type> snap_stdc;
+  for (unsigned long i(0); i != (op_test_cnt >> 3); ++i) {
+    const auto val(gen());
+    builder.push_back(val);
+    built.push_back(val);
+    if (mt() % 8192 == 0) {
+      snaps.push_back(builder.persistent());
+      snap_stdc.push_back(built);
+    }
+  }
+  same(builder.persistent(), built);
+  for (size_t v(0); v != snaps.size(); ++v) same(snaps[v], snap_stdc[v]);
+  same(usr[0], stdc[0]);
+}
+#endif
+
+#if defined(TEST_ROPE) || defined(TEST_GAP_BUFFER) || defined(TEST_SEGMENTED_VECTOR)
+// differential check for sequences that do not keep element addresses stable across insert/erase
+template <class test_type>
+void check_sequence_() {
+  using std_type = std::vector<I2P2::value_type>;
+  {
+    // popping an empty sequence does nothing, as with Vector
+    test_type e;
+    e.pop_back();
+    e.pop_front();
+    e.push_back(gen());
+    e.pop_front();
+    e.pop_back();
+    e.pop_front();
+    check(e.empty() && e.size() == 0, "pop on an empty sequence changed its size");
+  }
+  std::vector<std::unique_ptr<test_type>> usr;
+  usr.push_back(std::unique_ptr<test_type>(new test_type()));
+  usr.push_back(std::unique_ptr<test_type>(new test_type()));
+  std::vector<std_type> stdc(2);
+  std::uniform_int_distribution<> mode(0, 13);
+  std::uniform_int_distribution<> which(0, 1);
+  for (unsigned long i(0); i != (op_test_cnt >> 2); ++i) {
+    const auto select(which(mt));
+    auto &c(*usr[select]);
+    auto &s(stdc[select]);
+    std::uniform_int_distribution<size_t> pos_gen(0, s.size());
+    switch (mode(mt)) {
+      case 0:
+        usr[select].reset(new test_type());
+        stdc[select].clear();
+        break;
+      case 1:
+        usr[select].reset(new test_type(*usr[1 - select]));
+        stdc[select] = stdc[1 - select];
+        break;
+      case 2:
+        copy_assignment_operator()(c, *usr[1 - select], s, stdc[1 - select]);
+        break;
+      case 3:
+        back_and_front()(c, s);
+        back_and_front().operator()<const test_type &>(c, s);
+        break;
+      case 4:
+        clear()(c, s);
+        empty_and_size()(c, s);
+        break;
+      case 5:
+      case 6:
+        if (s.size()) {
+          const auto pos(pos_gen(mt) % s.size());
+          c.erase(c.begin() + pos);
+          s.erase(s.begin() + pos);
+        }
+        break;
+      case 7: {
+        auto begin(pos_gen(mt));
+        auto end(pos_gen(mt));
+        if (begin > end) std::swap(begin, end);
+        c.erase(c.begin() + begin, c.begin() + end);
+        s.erase(s.begin() + begin, s.begin() + end);
+        break;
+      }
+      case 8:
+      case 9: {
+        const auto pos(pos_gen(mt));
+        const auto cnt(std::uniform_int_distribution<size_t>(0, insert_cnt)(mt));
+        const auto val(gen());
+        c.insert(c.begin() + pos, cnt, val);
+        s.insert(s.begin() + pos, cnt, val);
+        break;
+      }
+      case 10: {
+        const auto pos(pos_gen(mt));
+        const auto &other(*usr[1 - select]);
+        c.insert(c.begin() + pos, other.begin(), other.end());
+        s.insert(s.begin() + pos, stdc[1 - select].begin(), stdc[1 - select].end());
+        break;
+      }
+      case 11: {
+        const auto val(gen());
+        if (mt() & 1) c.push_back(val), s.push_back(val);
+        else c.push_front(val), s.insert(s.begin(), val);
+        break;
+      }
+      case 12:
+        if (s.size()) {
+          if (mt() & 1) c.pop_back(), s.pop_back();
+          else c.pop_front(), s.erase(s.begin());
+        }
+        break;
+      case 13:
+        random_access()(c, s);
+        random_access().operator()<const test_type &>(c, s);
+        if (s.size()) {
+          const auto pos(pos_gen(mt) % s.size());
+          c[pos] = s[pos] = gen();
+        }
+        break;
+      default:
+        assert(false);
+    }
+    equal()(*usr[select], stdc[select]);
+    empty_and_size()(*usr[select], stdc[select]);
+    iterator_iterate()(*usr[select]);
+    iterator_iterate().operator()<const test_type &>(*usr[select]);
+    iterator_random()(*usr[select]);
+    iterator_random().operator()<const test_type &>(*usr[select]);
+  }
+}
+#endif
+
+#ifdef TEST_ROPE
+void check_rope() {
+  check_sequence_<I2P2::Rope>();
+
+  // grow well past a few tree levels and shrink back, so splits, merges and root changes all happen
+  I2P2::Rope c;
+  std::vector<I2P2::value_type> s;
+  const size_t big(I2P2::Rope::leaf_capacity * I2P2::Rope::fanout * 4);
+  for (int round(0); round != 2; ++round) {
+    while (s.size() < big) {
+      std::uniform_int_distribution<size_t> pos_gen(0, s.size());
+      const auto pos(pos_gen(mt));
+      const auto val(gen());
+      if (round) c.push_back(val), s.push_back(val);
+      else c.insert(c.begin() + pos, 1, val), s.insert(s.begin() + pos, val);
+    }
+    check(std::equal(s.begin(), s.end(), as_const(c).begin()), "content of rope is not equal");
+    std::vector<I2P2::value_type> flat;
+    c.for_each([&flat](I2P2::value_type val) { flat.push_back(val); });
+    check(flat == s, "for_each does not visit the rope in order");
+    while (s.size()) {
+      std::uniform_int_distribution<size_t> pos_gen(0, s.size() - 1);
+      const auto pos(pos_gen(mt));
+      const auto cnt(std::min<size_t>(s.size() - pos, 1 + mt() % insert_cnt));
+      c.erase(c.begin() + pos, c.begin() + pos + cnt);
+      s.erase(s.begin() + pos, s.begin() + pos + cnt);
+      if (!(mt() % 64)) check(std::equal(s.begin(), s.end(), as_const(c).begin()), "content of rope is not equal");
+    }
+    check(c.empty() && c.size() == 0, "rope is not empty after erasing everything");
+  }
+}
+#endif
+
+#ifdef TEST_GAP_BUFFER
+void check_gap_buffer() {
+  check_sequence_<I2P2::GapBuffer>();
+
+  // editor-style session: a cursor that wanders and types or deletes around itself
+  I2P2::GapBuffer c;
+  std::vector<I2P2::value_type> s;
+  size_t cur(0);
+  std::uniform_int_distribution<> mode(0, 5);
+  for (unsigned long i(0); i != (op_test_cnt >> 2); ++i) {
+    switch (mode(mt)) {
+      case 0: {
+        std::uniform_int_distribution<std::ptrdiff_t> step(-static_cast<std::ptrdiff_t>(insert_cnt), insert_cnt);
+        const auto pos(std::ptrdiff_t(cur) + step(mt));
+        cur = std::min<std::ptrdiff_t>(std::max<std::ptrdiff_t>(pos, 0), s.size());
+        c.move_cursor(cur);
+        break;
+      }
+      case 1:
+      case 2: {
+        const auto val(gen());
+        c.insert_at_cursor(val);
+        s.insert(s.begin() + cur++, val);
+        break;
+      }
+      case 3:
+        c.erase_before_cursor();
+        if (cur) s.erase(s.begin() + --cur);
+        break;
+      case 4:
+        c.erase_after_cursor();
+        if (cur != s.size()) s.erase(s.begin() + cur);
+        break;
+      case 5:
+        if (!(mt() % 64)) {
+          const auto data(c.data());
+          check(std::equal(s.begin(), s.end(), data), "contiguous view is not equal");
+          c.move_cursor(cur);
+        }
+        break;
+      default:
+        assert(false);
+    }
+    check(c.cursor() == cur, "cursor is not where it was moved");
+    empty_and_size()(c, s);
+  }
+  check(std::equal(s.begin(), s.end(), as_const(c).begin()), "content of gap buffer is not equal");
+}
+#endif
+
+#ifdef TEST_SEGMENTED_VECTOR
+void check_segmented_vector() {
+  check_sequence_<I2P2::SegmentedVector>();
+
+  // growth must never move an element
+  I2P2::SegmentedVector c;
+  std::vector<I2P2::value_type> s;
+  std::vector<const I2P2::value_type *> addr;
+  for (size_t i(0); i != I2P2::SegmentedVector::first_segment << 10; ++i) {
+    const auto old_capacity(c.capacity());
+    const auto val(gen());
+    c.push_back(val);
+    s.push_back(val);
+    addr.push_back(&as_const(c)[i]);
+    if (c.capacity() != old_capacity)
+      for (size_t j(0); j != addr.size(); ++j)
+        if (!check(addr[j] == &as_const(c)[j] && *addr[j] == s[j], "push_back moved an element")) return;
+  }
+  std::vector<I2P2::value_type> flat;
+  c.for_each([&flat](I2P2::value_type val) { flat.push_back(val); });
+  check(flat == s, "for_each does not visit the segments in order");
+  c.reserve(c.capacity() * 4);
+  check(addr.front() == &as_const(c)[0] && addr.back() == &as_const(c)[s.size() - 1], "reserve moved an element");
+  while (c.size() > I2P2::SegmentedVector::first_segment) c.pop_back();
+  c.shrink_to_fit();
+  check(c.capacity() == I2P2::SegmentedVector::first_segment && addr.front() == &as_const(c)[0],
+        "shrink_to_fit did not release only the unused segments");
+}
+#endif
+#ifdef TEST_STATIC_VECTOR
+#if __cplusplus >= 202002L
+constexpr I2P2::StaticVector<16> make_squares() {
+  I2P2::StaticVector<16> c;
+  for (int i(0); !c.full(); ++i) c.push_back(i * i);
+  c.pop_back();
+  return c;
+}
+constexpr I2P2::StaticVector<16> squares(make_squares());
+static_assert(squares.size() == 15 && squares[3] == 9 && squares.back() == 196, "StaticVector is not usable in constexpr");
+static_assert(I2P2::StaticVector<4>{1, 2, 3}.back() == 3, "StaticVector initializer list is not constexpr");
+#endif
+
+void check_static_vector() {
+  const size_t cap(64);
+  using test_type = I2P2::StaticVector<cap>;
+  test_type c, other;
+  std::vector<I2P2::value_type> s, other_s;
+  c.pop_back();
+  c.pop_front();
+  check(c.empty() && c.size() == 0, "pop on an empty static vector changed its size");
+  std::uniform_int_distribution<> mode(0, 7);
+  for (unsigned long i(0); i != (op_test_cnt >> 2); ++i) {
+    std::uniform_int_distribution<size_t> pos_gen(0, s.size());
+    switch (mode(mt)) {
+      case 0:
+        if (mt() & 1) other = c, other_s = s;
+        else c = other, s = other_s;
+        break;
+      case 1:
+        if (s.size()) {
+          const auto pos(pos_gen(mt) % s.size());
+          c.erase(c.begin() + pos);
+          s.erase(s.begin() + pos);
+        }
+        break;
+      case 2: {
+        auto begin(pos_gen(mt));
+        auto end(pos_gen(mt));
+        if (begin > end) std::swap(begin, end);
+        c.erase(c.begin() + begin, c.begin() + end);
+        s.erase(s.begin() + begin, s.begin() + end);
+        break;
+      }
+      case 3: {
+        const auto pos(pos_gen(mt));
+        const auto cnt(std::uniform_int_distribution<size_t>(0, insert_cnt)(mt));
+        const auto val(gen());
+        if (s.size() + cnt > cap) break;
+        c.insert(c.begin() + pos, cnt, val);
+        s.insert(s.begin() + pos, cnt, val);
+        break;
+      }
+      case 4: {
+        const auto pos(pos_gen(mt));
+        if (s.size() * 2 > cap) break;
+        // a piece of itself, which may straddle pos, or a range from another container
+        auto first(pos_gen(mt)), last(pos_gen(mt));
+        if (first > last) std::swap(first, last);
+        if (mt() % 2) {
+          c.insert(c.begin() + pos, as_const(c).begin() + first, as_const(c).begin() + last);
+          const std::vector<I2P2::value_type> tmp(s.begin() + first, s.begin() + last);
+          s.insert(s.begin() + pos, tmp.begin(), tmp.end());
+        } else {
+          I2P2::Vector other;
+          for (auto n(last - first); n; --n) other.push_back(gen());
+          c.insert(c.begin() + pos, as_const(other).begin(), as_const(other).end());
+          s.insert(s.begin() + pos, as_const(other).data(), as_const(other).data() + other.size());
+        }
+        break;
+      }
+      case 5: {
+        const auto val(gen());
+        if (s.size() == cap) {
+          check(!c.try_push_back(val), "try_push_back succeeded on a full static vector");
+          bool thrown(false);
+          try {
+            c.push_back(val);
+          } catch (const std::length_error &) {
+            thrown = true;
+          }
+          check(thrown && c.size() == cap, "push_back past the capacity did not throw");
+        } else if (mt() & 1) {
+          c.push_back(val), s.push_back(val);
+        } else {
+          c.push_front(val), s.insert(s.begin(), val);
+        }
+        break;
+      }
+      case 6:
+        if (s.size()) {
+          if (mt() & 1) c.pop_back(), s.pop_back();
+          else c.pop_front(), s.erase(s.begin());
+        }
+        break;
+      case 7:
+        random_access()(c, s);
+        back_and_front()(c, s);
+        empty_and_size()(c, s);
+        if (s.size()) {
+          const auto pos(pos_gen(mt) % s.size());
+          c[pos] = s[pos] = gen();
+        }
+        break;
+      default:
+        assert(false);
+    }
+    check(c.size() == s.size() && std::equal(s.begin(), s.end(), as_const(c).data()), "content of static vector is not equal");
+  }
+  check(c.capacity() == cap, "capacity of static vector changed");
+
+  // the same container behind the virtual interface
+  I2P2::randomaccess_adapter<test_type> adapted(c);
+  I2P2::randomaccess_container &r(adapted);
+  c.clear();
+  r.clear();
+  for (size_t i(0); i != cap / 2; ++i) {
+    const auto val(gen());
+    c.push_back(val);
+    r.push_front(val);
+  }
+  r.erase(r.begin());
+  c.pop_back();
+  bool same(r.size() == c.size() && !r.empty());
+  for (size_t i(0); same && i != c.size(); ++i) same = r[i] == c[c.size() - 1 - i];
+  check(same && r.front() == c.back() && adapted.get().size() == c.size(), "randomaccess_adapter does not forward");
+}
+#endif
+#ifdef TEST_SPAN
+void check_span() {
+  static_assert(!std::is_polymorphic<I2P2::VectorView>::value && !std::is_polymorphic<I2P2::StridedSpan>::value,
+                "views must not need virtual dispatch");
+  static_assert(std::is_trivially_copyable<I2P2::Span>::value, "views must be cheap to pass by value");
+
+  std::uniform_int_distribution<size_t> size_gen(0, insert_cnt * 8);
+  for (unsigned long i(0); i != (op_test_cnt >> 6); ++i) {
+    I2P2::Vector c;
+    std::vector<I2P2::value_type> s(size_gen(mt));
+    for (auto &val : s) val = gen();
+    c.append(s.data(), s.size());
+
+    // slicing
+    std::uniform_int_distribution<size_t> pos_gen(0, s.size());
+    auto begin(pos_gen(mt));
+    auto end(pos_gen(mt));
+    if (begin > end) std::swap(begin, end);
+    const I2P2::VectorView view(as_const(c));
+    const auto sub(view.subspan(begin, end - begin));
+    if (!check(sub.size() == end - begin && std::equal(sub.begin(), sub.end(), s.begin() + begin) &&
+               view.first(begin).size() == begin && view.last(s.size() - end).data() == as_const(c).data() + end,
+               "subspan does not view the right elements")) return;
+
+    // writes through a span land in the vector
+    I2P2::Span span(c);
+    for (auto &val : span.subspan(begin, end - begin)) val = gen();
+    for (size_t j(begin); j != end; ++j) s[j] = c[j];
+
+    // strided views
+    const size_t step(std::uniform_int_distribution<size_t>(1, 4)(mt));
+    const I2P2::StridedView strided(view.strided(step));
+    std::vector<I2P2::value_type> every;
+    for (size_t j(0); j < s.size(); j += step) every.push_back(s[j]);
+    bool same(strided.size() == every.size());
+    for (size_t j(0); same && j != every.size(); ++j) same = strided[j] == every[j];
+    if (!check(same, "strided view does not visit every step-th element")) return;
+    const auto val(gen());
+    for (size_t j(0); j != span.strided(step).size(); ++j) span.strided(step)[j] = val;
+    for (size_t j(0); j < s.size(); j += step) s[j] = val;
+
+    // Vector overloads taking views, including views of itself
+    I2P2::Vector d(sub);
+    if (!check(d.size() == sub.size() && std::equal(sub.begin(), sub.end(), as_const(d).data()),
+               "construction from a view is not equal")) return;
+    d.append(strided);
+    std::vector<I2P2::value_type> t(s.begin() + begin, s.begin() + end);
+    for (size_t j(0); j < s.size(); j += step) t.push_back(s[j]);
+    const auto at(std::uniform_int_distribution<size_t>(0, t.size())(mt));
+    d.insert(as_const(d).begin() + at, view);
+    t.insert(t.begin() + at, s.begin(), s.end());
+    const auto self_at(std::uniform_int_distribution<size_t>(0, t.size())(mt));
+    const std::vector<I2P2::value_type> u(t);
+    d.insert(as_const(d).begin() + self_at, I2P2::VectorView(as_const(d)));
+    t.insert(t.begin() + self_at, u.begin(), u.end());
+    if (!check(d.size() == t.size() && std::equal(t.begin(), t.end(), as_const(d).data()),
+               "insert of a view is not equal")) return;
+    c.assign(I2P2::VectorView(as_const(c)).subspan(begin, end - begin));
+    s = std::vector<I2P2::value_type>(s.begin() + begin, s.begin() + end);
+    c.append(I2P2::VectorView(as_const(c)));
+    const std::vector<I2P2::value_type> doubled(s);
+    s.insert(s.end(), doubled.begin(), doubled.end());
+    if (!check(c.size() == s.size() && std::equal(s.begin(), s.end(), as_const(c).data()),
+               "assign or append of a self view is not equal")) return;
+  }
+}
+#endif
+#ifdef TEST_TRACE
+void check_trace() {
+  char gen_path[] = "/tmp/I2P2_trace_XXXXXX";
+  char rec_path[] = "/tmp/I2P2_trace_XXXXXX";
+  const int gen_fd(mkstemp(gen_path));
+  const int rec_fd(mkstemp(rec_path));
+  if (!check(gen_fd >= 0 && rec_fd >= 0, "mkstemp failed")) return;
+  close(gen_fd);
+  close(rec_fd);
+
+  if (access("/dev/full", W_OK) == 0) {
+    // a device that is always full: the records cannot all land, and the writer must say so
+    I2P2::trace_writer full("/dev/full");
+    I2P2::generate_trace(full, mt(), 1 << 12);
+    check(!full.flush() && !full.ok(), "a failed trace write was not reported");
+  }
+
+  const auto seed(mt());
+  {
+    I2P2::trace_writer out(gen_path);
+    I2P2::generate_trace(out, seed, op_test_cnt >> 4);
+    check(out.flush() && out.ok(), "a trace that was written reports a failure");
+  }
+
+  // replay through the recording hook, mirrored on std::vector
+  std::vector<I2P2::trace_record> trace;
+  {
+    I2P2::trace_reader in(gen_path);
+    check(in.ok(), "trace_reader rejected a fresh trace");
+    I2P2::trace_record rec;
+    while (in.next(rec)) trace.push_back(rec);
+  }
+  check(trace.size() == (op_test_cnt >> 4), "trace lost records");
+  I2P2::Vector c;
+  std::vector<I2P2::value_type> s;
+  {
+    I2P2::trace_writer out(rec_path);
+    I2P2::traced<I2P2::Vector> hook(c, out);
+    for (const auto &rec : trace) {
+      const auto pos(static_cast<size_t>(rec.pos));
+      switch (rec.op) {
+        case I2P2::trace_push_back: hook.push_back(rec.val), s.push_back(rec.val); break;
+        case I2P2::trace_push_front: hook.push_front(rec.val), s.insert(s.begin(), rec.val); break;
+        case I2P2::trace_pop_back: hook.pop_back(), s.pop_back(); break;
+        case I2P2::trace_pop_front: hook.pop_front(), s.erase(s.begin()); break;
+        case I2P2::trace_insert:
+          hook.insert(pos, rec.count, rec.val);
+          s.insert(s.begin() + pos, rec.count, rec.val);
+          break;
+        case I2P2::trace_erase: hook.erase(pos), s.erase(s.begin() + pos); break;
+        case I2P2::trace_erase_range:
+          hook.erase(pos, rec.count);
+          s.erase(s.begin() + pos, s.begin() + (pos + rec.count));
+          break;
+        case I2P2::trace_clear: hook.clear(), s.clear(); break;
+        case I2P2::trace_read: check(hook.read(pos) == s[pos], "read through the hook is not equal"); break;
+        case I2P2::trace_write: hook.write(pos, rec.val), s[pos] = rec.val; break;
+        case I2P2::trace_iterate: {
+          size_t i(0);
+          hook.for_each([&s, &i](I2P2::value_type val) { check(val == s[i++], "iterate through the hook is not equal"); });
+          break;
+        }
+        case I2P2::trace_copy: check(hook.copy().size() == s.size(), "copy through the hook is not equal"); break;
+        default: assert(false);
+      }
+    }
+  }
+  check(c.size() == s.size() && std::equal(s.begin(), s.end(), as_const(c).data()), "content after replay is not equal");
+
+  // what the hook recorded is the trace it was fed
+  I2P2::trace_reader in(rec_path);
+  I2P2::trace_record rec;
+  size_t i(0);
+  while (in.next(rec)) {
+    const auto &want(trace[i++]);
+    if (!check(rec.op == want.op && rec.pos == want.pos && rec.count == want.count && rec.val == want.val,
+               "recorded trace differs from the replayed one")) break;
+  }
+  check(i == trace.size(), "recorded trace has a different length");
+
+  // a seed reproduces its trace
+  {
+    I2P2::trace_writer out(rec_path);
+    I2P2::generate_trace(out, seed, op_test_cnt >> 4);
+  }
+  I2P2::trace_reader again(rec_path);
+  i = 0;
+  while (again.next(rec) && i != trace.size() && rec.op == trace[i].op && rec.pos == trace[i].pos) ++i;
+  check(i == trace.size(), "generate_trace is not reproducible from its seed");
+  unlink(gen_path);
+  unlink(rec_path);
+}
+#endif
+#ifdef TEST_STATS
+#ifndef I2P2_STATS
+#error "TEST_STATS needs the counters compiled in (-DI2P2_STATS)"
+#endif
+void check_stats() {
+  const size_t elem(sizeof(I2P2::value_type));
+  I2P2::reset_global_stats();
+  {
+    I2P2::Vector v;
+    v.reserve(10);
+    for (int i(0); i != 10; ++i) v.push_back(i);
+    check(v.stats().allocations == 1 && v.stats().bytes_allocated == 10 * elem && v.stats().reallocations == 0,
+          "reserve is not counted as one allocation");
+    v.push_back(10);  // grows 10 -> 30
+    check(v.stats().allocations == 2 && v.stats().frees == 1 && v.stats().bytes_freed == 10 * elem,
+          "growth is not counted as an allocation and a free");
+    check(v.stats().reallocations == 1 && v.stats().elements_moved == 10 && v.stats().peak_capacity == 30,
+          "growth does not count the relocated elements");
+
+    const auto moved(v.stats().elements_moved);
+    v.insert(v.begin() + 1, 2, 7);
+    check(v.stats().elements_moved == moved + 10 && v.stats().elements_copied == 2, "insert shifts are not counted");
+    v.erase(v.begin());
+    check(v.stats().elements_moved == moved + 22, "erase shifts are not counted");
+
+    I2P2::Vector w(v);
+    check(w.stats().elements_copied == v.size() && w.stats().allocations == 1, "copy is not counted");
+    w.shrink_to_fit();
+    check(w.stats().allocations == 1, "shrink_to_fit of a full vector allocated");
+    w.append(v.data(), 3);
+    check(w.stats().elements_copied == v.size() + 3 && w.stats().peak_capacity == 36, "append is not counted");
+
+    I2P2::List l;
+    for (int i(0); i != 5; ++i) l.push_back(i);
+    l.pop_front();
+    // head and tail sentinels are nodes too
+    check(l.stats().allocations == 7 && l.stats().frees == 1 && l.stats().bytes_allocated == 7 * sizeof(I2P2::Node),
+          "list nodes are not counted");
+    check(l.stats().peak_capacity == 5 && l.stats().elements_moved == 0, "list peak size is not counted");
+    I2P2::List m(l);
+    check(m.stats().elements_copied == l.size(), "list copy is not counted");
+
+    const auto clones(I2P2::global_stats().iterator_clones);
+    auto it(v.begin());
+    it = v.end();
+    check(I2P2::global_stats().iterator_clones > clones, "iterator clones are not counted");
+  }
+
+  // everything above is gone, so the global counters must balance
+  const auto global(I2P2::global_stats());
+  check(global.allocations == global.frees && global.bytes_allocated == global.bytes_freed,
+        "global allocations and frees do not balance");
+  // w grew 12 -> 36 on append
+  check(global.peak_capacity == 36, "global peak capacity is not the largest container's");
+
+  std::vector<std::pair<std::string, uint64_t>> dumped;
+  I2P2::dump_stats(global, "i2p2", [](const char *name, uint64_t value, void *ctx) {
+    static_cast<std::vector<std::pair<std::string, uint64_t>> *>(ctx)->emplace_back(name, value);
+  }, &dumped);
+  check(dumped.size() == 9 && dumped[0].first == "i2p2.allocations" && dumped[0].second == global.allocations,
+        "dump_stats output is wrong");
+
+  // a spliced node's allocation moves with it: every list still holds exactly its nodes, sentinels included
+  {
+    I2P2::List a, b;
+    for (int i(0); i != 4; ++i) a.push_back(i);
+    a.splice(a.begin(), a, --a.end());
+    b.splice(b.end(), a, a.begin());
+    b.splice(b.end(), a, a.begin());
+    check(a.stats().allocations - a.stats().frees == a.size() + 2 &&
+              b.stats().allocations - b.stats().frees == b.size() + 2,
+          "splice left a node's allocation with its old list");
+  }
+
+  // swapping with a temporary, as hash_table::resize does: each vector's counters still account
+  // for exactly the buffer it holds
+  {
+    I2P2::Vector v(5, 1);
+    {
+      I2P2::Vector old;
+      old.swap(v);
+      v.reserve(20);
+    }
+    check(v.stats().bytes_allocated - v.stats().bytes_freed == v.capacity() * elem,
+          "swap left a buffer's counters with the other vector");
+  }
+  I2P2::reset_global_stats();
+  check(I2P2::global_stats().allocations == 0, "reset_global_stats did not reset");
+}
+#endif
+#ifdef TEST_LATENCY
+#ifndef I2P2_LATENCY
+#error "TEST_LATENCY needs the hooks compiled in (-DI2P2_LATENCY)"
+#endif
+void check_latency() {
+  // bucket edges: every value lands in a bucket whose top is within 1/16 above it
+  for (unsigned long i(0); i != op_test_cnt; ++i) {
+    const uint64_t ns(mt() >> (mt() % 64));
+    const uint64_t top(I2P2::latency_histogram::bucket_top(I2P2::latency_histogram::bucket_of(ns)));
+    if (!check(top >= ns && top - ns <= ns / 16, "latency bucket does not cover its value")) break;
+  }
+
+  I2P2::latency_histogram hist;
+  for (uint64_t ns(1); ns <= 10000; ++ns) hist.record(ns);
+  check(hist.count() == 10000 && hist.max() == 10000, "latency_histogram count or max is wrong");
+  check(hist.percentile(0.5) >= 5000 && hist.percentile(0.5) <= 5000 + 5000 / 16, "latency p50 is off");
+  check(hist.percentile(0.99) >= 9900 && hist.percentile(0.999) <= 10000, "latency tail percentiles are off");
+  check(I2P2::latency_histogram().percentile(0.5) == 0, "empty latency_histogram has a percentile");
+
+  // per-thread recording, merged after the threads are gone
+  const int thread_cnt(4);
+  const int op_cnt(10000);
+  I2P2::reset_latency();
+  std::vector<std::thread> threads;
+  for (int t(0); t != thread_cnt; ++t)
+    threads.emplace_back([op_cnt]() {
+      I2P2::Vector v;
+      I2P2::List l;
+      for (int i(0); i != op_cnt; ++i) v.push_back(i), l.push_front(i);
+      for (int i(0); i != op_cnt / 2; ++i) v.pop_back(), l.pop_back();
+      v.reserve(4 * op_cnt);
+      l.clear();
+    });
+  for (auto &t : threads) t.join();
+
+  const auto push_back(I2P2::latency_summary(I2P2::latency_push_back));
+  check(push_back.count == static_cast<uint64_t>(thread_cnt) * op_cnt, "push_back samples were lost");
+  check(push_back.p50 <= push_back.p99 && push_back.p99 <= push_back.p999 && push_back.p999 <= push_back.max,
+        "latency percentiles are not ordered");
+  check(I2P2::latency_summary(I2P2::latency_push_front).count == static_cast<uint64_t>(thread_cnt) * op_cnt,
+        "push_front samples were lost");
+  check(I2P2::latency_summary(I2P2::latency_pop_back).count == static_cast<uint64_t>(thread_cnt) * op_cnt,
+        "pop_back samples were lost");
+  // the reallocations inside push_back belong to push_back; only the explicit reserve is its own sample
+  check(I2P2::latency_summary(I2P2::latency_reserve).count == static_cast<uint64_t>(thread_cnt),
+        "reserve was not recorded once per call");
+  // one explicit clear per thread; destroying a List is not a clear
+  check(I2P2::latency_summary(I2P2::latency_clear).count == static_cast<uint64_t>(thread_cnt), "clear was not recorded");
+
+  // live threads are merged too; operations built on others are timed once, as the outer call
+  I2P2::List l;
+  for (int i(0); i != 3; ++i) l.push_back(i);
+  I2P2::reset_latency();
+  {
+    I2P2::Vector v(3, 1);
+    v.erase(v.begin());
+    I2P2::Vector w(v);
+    w = v;
+    v.push_front(2);
+    v.pop_front();
+    I2P2::List m(l);
+    m = l;
+  }
+  check(I2P2::latency_summary(I2P2::latency_copy).count == 4 && I2P2::latency_summary(I2P2::latency_erase).count == 1,
+        "the main thread's samples are missing");
+  check(I2P2::latency_summary(I2P2::latency_push_front).count == 1 &&
+            I2P2::latency_summary(I2P2::latency_pop_front).count == 1 &&
+            I2P2::latency_summary(I2P2::latency_insert).count == 0 &&
+            I2P2::latency_summary(I2P2::latency_push_back).count == 0 &&
+            I2P2::latency_summary(I2P2::latency_clear).count == 0,
+        "nested operations were recorded on their own");
+  I2P2::reset_latency();
+  check(I2P2::latency_summary(I2P2::latency_push_back).count == 0, "reset_latency did not reset");
+}
+#endif
+#ifdef TEST_FLAT_SET
+void check_flat_set() {
+  // the branchless search against std::lower_bound, including every position of a run of equal keys
+  for (unsigned long i(0); i != (op_test_cnt >> 6); ++i) {
+    std::vector<I2P2::value_type> sorted(mt() % insert_cnt);
+    for (auto &val : sorted) val = gen();
+    std::sort(sorted.begin(), sorted.end());
+    const auto key(gen());
+    if (!check(I2P2::flat_lower_bound(sorted.data(), sorted.size(), key) ==
+               static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin()),
+               "flat_lower_bound is not equal to std::lower_bound")) return;
+  }
+
+  I2P2::FlatSet c;
+  std::set<I2P2::value_type> s;
+  std::uniform_int_distribution<> mode(0, 5);
+  for (unsigned long i(0); i != (op_test_cnt >> 4); ++i) {
+    const auto key(gen());
+    switch (mode(mt)) {
+      case 0:
+        check(c.insert(key) == s.insert(key).second, "insert result is not equal");
+        break;
+      case 1: {
+        std::vector<I2P2::value_type> batch(mt() % (insert_cnt * 2));
+        for (auto &val : batch) val = gen();
+        size_t added(0);
+        for (auto val : batch) added += s.insert(val).second;
+        check(c.insert_many(batch.data(), batch.size()) == added, "insert_many count is not equal");
+        break;
+      }
+      case 2:
+        check(c.erase(key) == (s.erase(key) != 0), "erase result is not equal");
+        break;
+      case 3: {
+        const auto mod(2 + mt() % 5);
+        auto pred([mod](I2P2::value_type val) { return static_cast<unsigned long>(val) % mod == 0; });
+        size_t removed(0);
+        for (auto it(s.begin()); it != s.end();)
+          if (pred(*it)) it = s.erase(it), ++removed;
+          else ++it;
+        check(c.erase_if(pred) == removed, "erase_if count is not equal");
+        break;
+      }
+      case 4:
+        check(c.contains(key) == (s.count(key) != 0), "contains is not equal");
+        check(c.lower_bound(key) == static_cast<size_t>(std::distance(s.begin(), s.lower_bound(key))) &&
+              c.upper_bound(key) == static_cast<size_t>(std::distance(s.begin(), s.upper_bound(key))),
+              "lower_bound or upper_bound is not equal");
+        break;
+      case 5:
+        if (mt() % 64 == 0) c.clear(), s.clear();
+        // merging a view of itself adds nothing
+        check(c.insert_many(c.keys()) == 0, "insert_many of its own keys added some");
+        break;
+      default:
+        assert(false);
+    }
+    if (!check(c.size() == s.size() && std::equal(s.begin(), s.end(), c.data()), "content of flat set is not equal"))
+      return;
+  }
+}
+#endif
+#ifdef TEST_FLAT_MAP
+void check_flat_map() {
+  I2P2::FlatMap c;
+  std::map<I2P2::value_type, I2P2::value_type> s;
+  std::uniform_int_distribution<> mode(0, 6);
+  for (unsigned long i(0); i != (op_test_cnt >> 4); ++i) {
+    const auto key(gen());
+    const auto val(gen());
+    switch (mode(mt)) {
+      case 0:
+        check(c.insert(key, val) == s.insert(std::make_pair(key, val)).second, "insert result is not equal");
+        break;
+      case 1: {
+        const bool added(s.count(key) == 0);
+        s[key] = val;
+        check(c.insert_or_assign(key, val) == added, "insert_or_assign result is not equal");
+        break;
+      }
+      case 2: {
+        // duplicate keys in the batch: std::map::insert keeps the first, and so must insert_many
+        const size_t n(mt() % (insert_cnt * 2));
+        std::vector<I2P2::value_type> keys(n), values(n);
+        size_t added(0);
+        for (size_t j(0); j != n; ++j) {
+          keys[j] = gen(), values[j] = gen();
+          added += s.insert(std::make_pair(keys[j], values[j])).second;
+        }
+        check(c.insert_many(I2P2::VectorView(keys.data(), n), I2P2::VectorView(values.data(), n)) == added,
+              "insert_many count is not equal");
+        break;
+      }
+      case 3:
+        check(c.erase(key) == (s.erase(key) != 0), "erase result is not equal");
+        break;
+      case 4: {
+        auto pred([](I2P2::value_type k, I2P2::value_type v) { return k < v; });
+        size_t removed(0);
+        for (auto it(s.begin()); it != s.end();)
+          if (pred(it->first, it->second)) it = s.erase(it), ++removed;
+          else ++it;
+        check(c.erase_if(pred) == removed, "erase_if count is not equal");
+        break;
+      }
+      case 5:
+        c[key] += val;
+        s[key] += val;
+        break;
+      case 6: {
+        const auto it(s.find(key));
+        if (it == s.end()) {
+          bool thrown(false);
+          try { c.at(key); } catch (const std::out_of_range &) { thrown = true; }
+          check(thrown && !c.contains(key), "at did not throw for a missing key");
+        } else check(c.at(key) == it->second && c.key_at(c.find(key)) == key, "at is not equal");
+        break;
+      }
+      default:
+        assert(false);
+    }
+    bool same(c.size() == s.size());
+    size_t j(0);
+    for (auto it(s.begin()); same && it != s.end(); ++it, ++j)
+      same = c.key_at(j) == it->first && c.value_at(j) == it->second;
+    if (!check(same, "content of flat map is not equal")) return;
+  }
+}
+#endif
+#ifdef TEST_EYTZINGER_INDEX
+void check_eytzinger_index() {
+  I2P2::EytzingerIndex empty;
+  check(empty.lower_bound(gen()) == 0 && empty.find(gen()) == 0, "empty index found something");
+
+  // every size up to a few full levels, then random larger ones; duplicates included
+  for (unsigned long i(0); i != (op_test_cnt >> 8); ++i) {
+    const size_t n(i < 300 ? i : mt() % (insert_cnt * 500));
+    I2P2::Vector sorted;
+    for (size_t j(0); j != n; ++j) sorted.push_back(gen());
+    std::sort(sorted.data(), sorted.data() + n);
+    const I2P2::EytzingerIndex index(sorted);
+
+    std::vector<I2P2::value_type> keys(insert_cnt * 3);
+    for (auto &key : keys) key = gen();
+    // keys outside the stored range as well
+    keys[0] = 0;
+    keys[1] = arithmetic_range;
+    std::vector<size_t> batch(keys.size());
+    index.lower_bound_many(I2P2::VectorView(keys.data(), keys.size()), batch.data());
+    for (size_t j(0); j != keys.size(); ++j) {
+      const auto *const begin(as_const(sorted).data());
+      const auto expect(static_cast<size_t>(std::lower_bound(begin, begin + n, keys[j]) - begin));
+      const auto found(index.find(keys[j]));
+      if (!check(index.lower_bound(keys[j]) == expect, "eytzinger lower_bound is not equal to std::lower_bound") ||
+          !check(batch[j] == expect, "eytzinger lower_bound_many is not equal to std::lower_bound") ||
+          !check(found == (expect != n && sorted[expect] == keys[j] ? expect : n), "eytzinger find is not equal"))
+        return;
+    }
+  }
+}
+#endif
+#ifdef TEST_HASH_SET
+void check_hash_set() {
+  I2P2::HashSet c;
+  std::unordered_set<I2P2::value_type> s;
+  std::uniform_int_distribution<> mode(0, 6);
+  for (unsigned long i(0); i != (op_test_cnt >> 4); ++i) {
+    const auto key(gen());
+    switch (mode(mt)) {
+      case 0:
+      case 1:
+        check(c.insert(key) == s.insert(key).second, "insert result is not equal");
+        break;
+      case 2:
+        // erase and insert in turn over a small key range piles up tombstones
+        check(c.erase(key) == (s.erase(key) != 0), "erase result is not equal");
+        break;
+      case 3: {
+        const size_t n(mt() % (insert_cnt * 4));
+        c.reserve(s.size() + n);
+        const size_t capacity(c.capacity());
+        for (size_t j(0); j != n; ++j) {
+          const auto k(gen());
+          check(c.insert(k) == s.insert(k).second, "insert after reserve is not equal");
+        }
+        check(c.capacity() == capacity, "reserve did not make room for the inserts");
+        break;
+      }
+      case 4:
+        if (mt() % 64 == 0) {
+          c.clear();
+          s.clear();
+        } else c.rehash(mt() % 2 ? 0 : s.size() * 2);
+        break;
+      case 5: {
+        // heterogeneous keys: an int finds its value, keys value_type cannot hold are absent
+        const int as_int(static_cast<int>(key));
+        check(c.contains(as_int) == (s.count(key) != 0), "contains(int) is not equal");
+        check(!c.contains(0.5) && !c.contains(-1.5) && c.count(key) == s.count(key), "count is not equal");
+        if (!std::is_floating_point<I2P2::value_type>::value)
+          check(c.contains(1e30) == false, "contains found a key out of range");
+        break;
+      }
+      case 6:
+        check(c.contains(key) == (s.count(key) != 0), "contains is not equal");
+        break;
+      default:
+        assert(false);
+    }
+    size_t seen(0);
+    bool same(c.size() == s.size());
+    c.for_each([&](I2P2::value_type k) { ++seen, same = same && s.count(k) != 0; });
+    if (!check(same && seen == s.size(), "content of hash set is not equal")) return;
+  }
+}
+#endif
+#ifdef TEST_HASH_MAP
+void check_hash_map() {
+  I2P2::HashMap c;
+  std::unordered_map<I2P2::value_type, I2P2::value_type> s;
+  std::uniform_int_distribution<> mode(0, 7);
+  for (unsigned long i(0); i != (op_test_cnt >> 4); ++i) {
+    const auto key(gen());
+    const auto val(gen());
+    switch (mode(mt)) {
+      case 0:
+        check(c.insert(key, val) == s.insert(std::make_pair(key, val)).second, "insert result is not equal");
+        break;
+      case 1: {
+        const bool added(s.count(key) == 0);
+        s[key] = val;
+        check(c.insert_or_assign(key, val) == added, "insert_or_assign result is not equal");
+        break;
+      }
+      case 2:
+        check(c.erase(key) == (s.erase(key) != 0), "erase result is not equal");
+        break;
+      case 3:
+        c[key] += val;
+        s[key] += val;
+        break;
+      case 4: {
+        const auto it(s.find(key));
+        if (it == s.end()) {
+          bool thrown(false);
+          try { c.at(key); } catch (const std::out_of_range &) { thrown = true; }
+          check(thrown && c.find(key) == nullptr, "at did not throw for a missing key");
+        } else check(c.at(key) == it->second && *c.find(static_cast<int>(key)) == it->second, "at is not equal");
+        check(c.find(0.5) == nullptr && !c.contains(-1.5), "find matched a key value_type cannot hold");
+        break;
+      }
+      case 5: {
+        // values move along with their keys when reserve rebuilds the table
+        const size_t n(mt() % (insert_cnt * 4));
+        c.reserve(s.size() + n);
+        for (size_t j(0); j != n; ++j) {
+          const auto k(gen()), v(gen());
+          check(c.insert(k, v) == s.insert(std::make_pair(k, v)).second, "insert after reserve is not equal");
+        }
+        break;
+      }
+      case 6:
+        if (mt() % 64 == 0) {
+          c.clear();
+          s.clear();
+        } else c.rehash(mt() % 2 ? 0 : s.size() * 2);
+        break;
+      case 7:
+        // a value already in the map, passed back by reference while the insert may rebuild
+        if (const auto *const v = c.find(val)) {
+          c.insert_or_assign(key, *v);
+          s[key] = s[val];
+        }
+        break;
+      default:
+        assert(false);
+    }
+    size_t seen(0);
+    bool same(c.size() == s.size());
+    c.for_each([&](I2P2::value_type k, I2P2::value_type &v) {
+      const auto it(s.find(k));
+      ++seen, same = same && it != s.end() && it->second == v;
+    });
+    if (!check(same && seen == s.size(), "content of hash map is not equal")) return;
+  }
+}
+#endif
+#ifdef TEST_LRU_CACHE
+void check_lru_cache() {
+  {
+    // splice relinks within a list and across lists
+    I2P2::List a, b;
+    std::list<I2P2::value_type> sa, sb;
+    for (int i(0); i != insert_cnt; ++i) a.push_back(gen()), b.push_back(gen());
+    sa.assign(a.begin(), a.end());
+    sb.assign(b.begin(), b.end());
+    for (int i(0); i != insert_cnt * 4 && !sa.empty(); ++i) {
+      const bool across(mt() % 2);
+      I2P2::List &to(across ? b : a);
+      std::list<I2P2::value_type> &sto(across ? sb : sa);
+      const auto from_pos(mt() % sa.size()), to_pos(mt() % (sto.size() + 1));
+      auto it(a.begin());
+      std::advance(it, from_pos);
+      auto pos(to.begin());
+      std::advance(pos, to_pos);
+      auto sit(sa.begin());
+      std::advance(sit, from_pos);
+      auto spos(sto.begin());
+      std::advance(spos, to_pos);
+      to.splice(pos, a, it);
+      sto.splice(spos, sa, sit);
+      if (!check(a.size() == sa.size() && b.size() == sb.size() && std::equal(sa.begin(), sa.end(), a.begin()) &&
+                 std::equal(sb.begin(), sb.end(), b.begin()), "splice is not equal to std::list::splice"))
+        return;
+    }
+  }
+
+  // a byte-capped cache, filled and then churned, never holds more than its budget
+  for (size_t budget : {size_t(0), size_t(1000), size_t(4096), size_t(6000)}) {
+    I2P2::LRUCache c(budget, I2P2::LRUCache::bytes);
+    check(c.capacity() == I2P2::LRUCache::entries_for(budget), "byte capacity is not entries_for");
+    for (unsigned long i(0); i != 1 << 14; ++i) {
+      // distinct keys first, so the cache fills up, then a mix of hits and evictions
+      const auto key(static_cast<I2P2::value_type>(i < c.capacity() ? i : mt() % 256));
+      c.put(key, gen());
+      if (i % 16 == 0) c.erase(static_cast<I2P2::value_type>(mt() % 256));
+      if (!check(c.footprint() <= budget, "lru cache grew past its byte budget")) break;
+    }
+    check(c.capacity() == 0 || c.size() + 1 >= c.capacity(), "byte-capped lru cache did not fill");
+  }
+  for (unsigned long round(0); round != (op_test_cnt >> 12); ++round) {
+    const size_t capacity(mt() % (insert_cnt * 3));
+    I2P2::LRUCache c(capacity);
+    // most recent first
+    std::list<std::pair<I2P2::value_type, I2P2::value_type>> s;
+    const auto find([&s](I2P2::value_type key) {
+      return std::find_if(s.begin(), s.end(), [key](const std::pair<I2P2::value_type, I2P2::value_type> &e) {
+        return e.first == key;
+      });
+    });
+    std::uniform_int_distribution<> mode(0, 5);
+    for (unsigned long i(0); i != 256; ++i) {
+      // keys from a range a little wider than the capacity, so hits and evictions both happen
+      const I2P2::value_type key(static_cast<I2P2::value_type>(mt() % (capacity * 2 + 1)));
+      const auto val(gen());
+      const auto it(find(key));
+      switch (mode(mt)) {
+        case 0:
+        case 1: {
+          const bool added(it == s.end());
+          if (!added) s.erase(it);
+          if (capacity != 0) {
+            s.emplace_front(key, val);
+            if (s.size() > capacity) s.pop_back();
+          }
+          check(c.put(key, val) == (added && capacity != 0), "put result is not equal");
+          break;
+        }
+        case 2: {
+          I2P2::value_type out(0);
+          const bool hit(c.get(key, out));
+          check(hit == (it != s.end()) && (!hit || out == it->second), "get is not equal");
+          if (it != s.end()) s.splice(s.begin(), s, it);
+          break;
+        }
+        case 3: {
+          const auto *const v(c.peek(key));
+          check((v == nullptr) == (it == s.end()) && (v == nullptr || *v == it->second) &&
+                c.contains(key) == (it != s.end()), "peek is not equal");
+          break;
+        }
+        case 4:
+          check(c.erase(key) == (it != s.end()), "erase result is not equal");
+          if (it != s.end()) s.erase(it);
+          break;
+        case 5:
+          if (mt() % 16 == 0) {
+            c.clear();
+            s.clear();
+          }
+          break;
+        default:
+          assert(false);
+      }
+      auto expect(s.begin());
+      bool same(c.size() == s.size());
+      c.for_each([&](I2P2::value_type k, I2P2::value_type v) {
+        same = same && expect != s.end() && expect->first == k && expect->second == v;
+        ++expect;
+      });
+      if (!check(same, "content or order of lru cache is not equal")) return;
+    }
+  }
+
+  // each thread owns the keys equal to its index modulo the thread count; every shard could hold them all
+  I2P2::ShardedLRUCache sharded(256 * 8, 8);
+  const unsigned threads_cnt(4);
+  std::vector<std::thread> threads;
+  std::atomic<unsigned> bad(0);
+  for (unsigned t(0); t != threads_cnt; ++t)
+    threads.emplace_back([&sharded, &bad, t]() {
+      std::vector<int> last(256, -1);
+      std::mt19937 rng(t);
+      for (int i(0); i != 20000; ++i) {
+        const unsigned key((rng() % 64) * threads_cnt + t);
+        const I2P2::value_type k(static_cast<I2P2::value_type>(key));
+        if (rng() % 2) {
+          const int v(static_cast<int>(rng() % 100));
+          sharded.put(k, static_cast<I2P2::value_type>(v));
+          last[key] = v;
+        } else {
+          I2P2::value_type out(0);
+          const bool hit(sharded.get(k, out));
+          if (hit != (last[key] >= 0) || (hit && out != static_cast<I2P2::value_type>(last[key]))) ++bad;
+        }
+      }
+    });
+  for (auto &thread : threads) thread.join();
+  check(bad == 0 && sharded.size() <= 256, "sharded lru cache lost or mixed up values");
+}
+#endif
+#ifdef TEST_PRIORITY_QUEUE
+void check_priority_queue() {
+  bool thrown(false);
+  try { I2P2::PriorityQueue c(1); } catch (const std::invalid_argument &) { thrown = true; }
+  check(thrown, "arity 1 did not throw");
+  I2P2::PriorityQueue empty_queue;
+  I2P2::IndexedPriorityQueue empty_indexed;
+  empty_queue.pop();
+  empty_indexed.pop();
+  check(empty_queue.empty() && empty_indexed.empty(), "pop on an empty queue changed it");
+
+  for (unsigned long round(0); round != (op_test_cnt >> 12); ++round) {
+    const size_t arity(2 + mt() % 7);
+    const bool min(mt() % 2);
+    I2P2::PriorityQueue c(arity, min ? I2P2::min_first : I2P2::max_first);
+    // std::priority_queue puts the largest first under std::less, so min_first flips the comparison
+    const auto less([min](I2P2::value_type a, I2P2::value_type b) { return min ? b < a : a < b; });
+    std::priority_queue<I2P2::value_type, std::vector<I2P2::value_type>, decltype(less)> s(less);
+    std::uniform_int_distribution<> mode(0, 5);
+    for (unsigned long i(0); i != 256; ++i) {
+      const auto val(gen());
+      switch (mode(mt)) {
+        case 0:
+        case 1:
+          c.push(val);
+          s.push(val);
+          break;
+        case 2:
+          if (!s.empty()) {
+            c.pop();
+            s.pop();
+          }
+          break;
+        case 3: {
+          // push_pop is a push then a pop, returning what left
+          s.push(val);
+          const auto expect(s.top());
+          s.pop();
+          check(c.push_pop(val) == expect, "push_pop is not equal");
+          break;
+        }
+        case 4: {
+          // bulk build, both by copy and by taking over a Vector
+          const size_t n(mt() % (insert_cnt * 10));
+          I2P2::Vector src;
+          while (!s.empty()) s.pop();
+          for (size_t j(0); j != n; ++j) {
+            src.push_back(gen());
+            s.push(src.back());
+          }
+          if (mt() % 2) c.assign(src);
+          else {
+            c.heapify(src);
+            check(src.empty(), "heapify did not take the source buffer");
+          }
+          break;
+        }
+        case 5:
+          if (mt() % 16 == 0) {
+            c.clear();
+            while (!s.empty()) s.pop();
+          }
+          break;
+        default:
+          assert(false);
+      }
+      const I2P2::VectorView heap(c.view());
+      bool ordered(true);
+      for (size_t j(1); ordered && j < heap.size(); ++j) ordered = !less(heap[(j - 1) / arity], heap[j]);
+      if (!check(c.size() == s.size() && (s.empty() || c.top() == s.top()) && ordered,
+                 "priority queue is not equal or not a heap"))
+        return;
+    }
+  }
+
+  // decrease-key: the model is a set of (priority, id) pairs, smallest first
+  for (unsigned long round(0); round != (op_test_cnt >> 12); ++round) {
+    I2P2::IndexedPriorityQueue c(2 + mt() % 7);
+    std::set<std::pair<I2P2::value_type, size_t>> s;
+    std::map<size_t, I2P2::value_type> priority;
+    std::uniform_int_distribution<> mode(0, 4);
+    for (unsigned long i(0); i != 256; ++i) {
+      const size_t id(mt() % (insert_cnt * 2));
+      const auto val(gen());
+      const auto it(priority.find(id));
+      switch (mode(mt)) {
+        case 0:
+        case 1:
+          c.push(id, val);
+          if (it != priority.end()) s.erase(std::make_pair(it->second, id));
+          s.insert(std::make_pair(val, id));
+          priority[id] = val;
+          break;
+        case 2:
+          if (it != priority.end()) {
+            c.update(id, val);
+            s.erase(std::make_pair(it->second, id));
+            s.insert(std::make_pair(val, id));
+            it->second = val;
+          }
+          break;
+        case 3:
+          if (!s.empty()) {
+            // ties may leave in any order, so drop whichever id the queue chose
+            const size_t top(c.top());
+            check(c.top_priority() == s.begin()->first && priority.count(top) &&
+                  priority[top] == s.begin()->first, "top is not a smallest priority");
+            s.erase(std::make_pair(priority[top], top));
+            priority.erase(top);
+            c.pop();
+          }
+          break;
+        case 4:
+          check(c.erase(id) == (it != priority.end()), "erase result is not equal");
+          if (it != priority.end()) {
+            s.erase(std::make_pair(it->second, id));
+            priority.erase(it);
+          }
+          break;
+        default:
+          assert(false);
+      }
+      bool same(c.size() == s.size() && (s.empty() || c.top_priority() == s.begin()->first));
+      for (const auto &entry : priority)
+        same = same && c.contains(entry.first) && c.priority(entry.first) == entry.second;
+      if (!check(same, "indexed priority queue is not equal")) return;
+    }
+  }
+}
+#endif
+#ifdef TEST_SLOT_MAP
+void check_slot_map() {
+  I2P2::SlotMap c;
+  // the model keys live elements by handle; erased handles are kept to check they stay stale
+  std::map<std::pair<uint32_t, uint32_t>, I2P2::value_type> s;
+  std::vector<I2P2::slot_handle> live, stale;
+  const I2P2::slot_handle zero = {0, 0};
+  std::uniform_int_distribution<> mode(0, 5);
+  for (unsigned long i(0); i != (op_test_cnt >> 4); ++i) {
+    const auto val(gen());
+    switch (mode(mt)) {
+      case 0:
+      case 1: {
+        const I2P2::slot_handle handle(c.insert(val));
+        check(!s.count(std::make_pair(handle.index, handle.generation)), "insert returned a live handle");
+        s[std::make_pair(handle.index, handle.generation)] = val;
+        live.push_back(handle);
+        break;
+      }
+      case 2:
+        if (!live.empty()) {
+          const size_t pick(mt() % live.size());
+          const I2P2::slot_handle handle(live[pick]);
+          check(c.erase(handle) && !c.erase(handle), "erase of a live handle is not true exactly once");
+          s.erase(std::make_pair(handle.index, handle.generation));
+          live[pick] = live.back();
+          live.pop_back();
+          stale.push_back(handle);
+        }
+        break;
+      case 3:
+        if (!live.empty()) {
+          const I2P2::slot_handle handle(live[mt() % live.size()]);
+          c[handle] += val;
+          s[std::make_pair(handle.index, handle.generation)] += val;
+        }
+        break;
+      case 4:
+        if (!stale.empty()) {
+          const I2P2::slot_handle handle(stale[mt() % stale.size()]);
+          bool thrown(false);
+          try { c.at(handle); } catch (const std::out_of_range &) { thrown = true; }
+          check(thrown && !c.contains(handle) && c.get(handle) == nullptr && !c.contains(zero),
+                "a stale handle still reaches a value");
+        }
+        break;
+      case 5:
+        if (mt() % 64 == 0) {
+          c.clear();
+          s.clear();
+          stale.insert(stale.end(), live.begin(), live.end());
+          live.clear();
+        }
+        break;
+      default:
+        assert(false);
+    }
+    if (stale.size() > insert_cnt * 10) stale.erase(stale.begin(), stale.begin() + insert_cnt);
+
+    // the dense array holds exactly the live values, and each position knows its handle
+    const I2P2::VectorView values(as_const(c).values());
+    bool same(c.size() == s.size() && values.size() == s.size());
+    for (size_t j(0); same && j != values.size(); ++j) {
+      const I2P2::slot_handle handle(c.handle_at(j));
+      const auto it(s.find(std::make_pair(handle.index, handle.generation)));
+      same = it != s.end() && it->second == values[j] && c.at(handle) == values[j];
+    }
+    if (!check(same, "content of slot map is not equal")) return;
+  }
+}
+#endif
+#ifdef TEST_PACKED_VECTOR
+void check_packed_vector() {
+  bool thrown(false);
+  try { I2P2::PackedVector c(65); } catch (const std::invalid_argument &) { thrown = true; }
+  check(thrown, "width 65 did not throw");
+  I2P2::PackedVector flags(10, 0, 1);
+  flags[3] = 1;
+  check(flags.count(2) == 0 && flags.find_first(2) == flags.size(), "a value wider than the fields was found");
+  I2P2::PackedVector codes(2);
+  codes.pop_back();
+  codes.insert(1, 3, 1);
+  codes.erase(0, 1);
+  check(codes.empty() && codes.word_count() == 0, "pop, insert or erase out of range changed an empty vector");
+
+  for (unsigned long round(0); round != (op_test_cnt >> 11); ++round) {
+    // mostly flags and small codes, sometimes a width that leaves bits over in each word
+    const unsigned widths[] = {1, 1, 2, 3, 4, 5, 7, 8, 13, 32, 63, 64};
+    const unsigned width(widths[mt() % (sizeof(widths) / sizeof(widths[0]))]);
+    const uint64_t mask(width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1);
+    // small values, so equal elements are common enough to count and find
+    const auto value([mask]() { return (mt() % 4 ? mt() % 3 : mt()) & mask; });
+    I2P2::PackedVector c(width);
+    std::vector<uint64_t> s;
+    std::uniform_int_distribution<> mode(0, 9);
+    for (unsigned long i(0); i != 128; ++i) {
+      const uint64_t val(value());
+      const size_t pos(mt() % (s.size() + 1));
+      switch (mode(mt)) {
+        case 0:
+        case 1:
+          c.push_back(val);
+          s.push_back(val);
+          break;
+        case 2:
+          if (!s.empty()) {
+            c.pop_back();
+            s.pop_back();
+          }
+          break;
+        case 3: {
+          const size_t n(mt() % insert_cnt);
+          c.insert(pos, n, val);
+          s.insert(s.begin() + pos, n, val);
+          break;
+        }
+        case 4: {
+          const size_t last(pos + mt() % (s.size() - pos + 1));
+          c.erase(pos, last);
+          s.erase(s.begin() + pos, s.begin() + last);
+          break;
+        }
+        case 5:
+          if (pos != s.size()) {
+            // through the proxy, including one element assigned from another
+            c[pos] = val;
+            s[pos] = val;
+            const size_t other(mt() % s.size());
+            c[other] = c[pos];
+            s[other] = s[pos];
+          }
+          break;
+        case 6: {
+          const size_t last(pos + mt() % (s.size() - pos + 1));
+          if (mt() % 2) {
+            c.set(pos, last, val);
+            std::fill(s.begin() + pos, s.begin() + last, val);
+          } else {
+            c.reset(pos, last);
+            std::fill(s.begin() + pos, s.begin() + last, 0);
+          }
+          break;
+        }
+        case 7: {
+          // sometimes a value wider than the fields, which no element can equal
+          const uint64_t key(width != 64 && mt() % 4 == 0 ? val | (mask + 1) : val);
+          const size_t from(mt() % (s.size() + 2));
+          const auto it(from < s.size() ? std::find(s.begin() + from, s.end(), key) : s.end());
+          check(c.count(key) == static_cast<size_t>(std::count(s.begin(), s.end(), key)), "count is not equal");
+          check(c.find_first(key, from) == static_cast<size_t>(it - s.begin()), "find_first is not equal");
+          break;
+        }
+        case 8: {
+          I2P2::PackedVector other(width);
+          std::vector<uint64_t> t(s.size());
+          for (auto &e : t) other.push_back(e = value());
+          switch (mt() % 4) {
+            case 0:
+              c &= other;
+              for (size_t j(0); j != s.size(); ++j) s[j] &= t[j];
+              break;
+            case 1:
+              c |= other;
+              for (size_t j(0); j != s.size(); ++j) s[j] |= t[j];
+              break;
+            case 2:
+              c ^= other;
+              for (size_t j(0); j != s.size(); ++j) s[j] ^= t[j];
+              break;
+            default:
+              c.flip();
+              for (auto &e : s) e = ~e & mask;
+          }
+          break;
+        }
+        case 9: {
+          const size_t n(mt() % (insert_cnt * 8));
+          c.resize(n, val);
+          s.resize(n, val);
+          break;
+        }
+        default:
+          assert(false);
+      }
+      bool same(c.size() == s.size() && c.word_count() == (s.size() + 64 / width - 1) / (64 / width));
+      for (size_t j(0); same && j != s.size(); ++j) same = as_const(c)[j] == s[j];
+      if (!check(same, "content of packed vector is not equal")) return;
+    }
+  }
+}
+#endif
+
+struct fuzz_target {
+  const char *name;
+  void (*run)();
+};
+
+int fuzz(unsigned workers, unsigned long long seed) {
+  if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+  // the differential tests: each worker owns its containers and its mt
+  const fuzz_target targets[] = {
+#ifdef TEST_LIST
+    {"list", check_list},
+#endif
+#ifdef TEST_VECTOR
+    {"vector", check_vector},
+#endif
+#ifdef TEST_COW_VECTOR
+    {"cow vector", check_cow_vector},
+#endif
+#ifdef TEST_PERSISTENT_VECTOR
+    {"persistent vector", check_persistent_vector},
+#endif
+#ifdef TEST_ROPE
+    {"rope", check_rope},
+#endif
+#ifdef TEST_GAP_BUFFER
+    {"gap buffer", check_gap_buffer},
+#endif
+#ifdef TEST_SEGMENTED_VECTOR
+    {"segmented vector", check_segmented_vector},
+#endif
+#ifdef TEST_FLAT_SET
+    {"flat set", check_flat_set},
+#endif
+#ifdef TEST_FLAT_MAP
+    {"flat map", check_flat_map},
+#endif
+#ifdef TEST_EYTZINGER_INDEX
+    {"eytzinger index", check_eytzinger_index},
+#endif
+#ifdef TEST_HASH_SET
+    {"hash set", check_hash_set},
+#endif
+#ifdef TEST_HASH_MAP
+    {"hash map", check_hash_map},
+#endif
+#ifdef TEST_LRU_CACHE
+    {"lru cache", check_lru_cache},
+#endif
+#ifdef TEST_PRIORITY_QUEUE
+    {"priority queue", check_priority_queue},
+#endif
+#ifdef TEST_SLOT_MAP
+    {"slot map", check_slot_map},
+#endif
+#ifdef TEST_PACKED_VECTOR
+    {"packed vector", check_packed_vector},
+#endif
+    {nullptr, nullptr}
+  };
+
+  int failed(0);
+  for (const fuzz_target *target(targets); target->name; ++target) {
+    std::cout << "Fuzzing " << target->name << " with " << workers << " workers ..." << std::endl;
+    // worker i runs on seed + i, so "-j 1 --seed <its seed>" repeats it alone
+    std::vector<unsigned long> worker_failures(workers);
+    std::vector<std::thread> threads;
+    for (unsigned i(0); i != workers; ++i)
+      threads.emplace_back([target, seed, i, &worker_failures]() {
+        mt.seed(seed + i);
+        failure_tag = "[" + std::string(target->name) + ", seed " + std::to_string(seed + i) + "] ";
+        target->run();
+        worker_failures[i] = failures;
+      });
+    for (auto &t : threads) t.join();
+    for (unsigned i(0); i != workers; ++i)
+      if (worker_failures[i]) {
+        ++failed;
+        std::cerr << target->name << ": " << worker_failures[i] << " failed checks with seed " << seed + i
+                  << ", reproduce with -j 1 --seed " << seed + i << '\n';
+      }
+  }
+  return failed;
+}
 }  // namespace I2P2_test
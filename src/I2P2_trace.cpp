@@ -0,0 +1,179 @@
+#include "../header/I2P2_trace.h"
+#include <random>
+#include <cstring>
+
+namespace I2P2
+{
+  namespace
+  {
+    const char magic[8] = {'I', '2', 'P', '2', 'T', 'R', 'C', '1'};
+
+    // on-disk record: fixed field order, padding zeroed
+    struct disk_record
+    {
+      uint64_t pos;
+      uint64_t count;
+      value_type val;
+      uint8_t op;
+    };
+  }
+
+  const char *const trace_op_names[trace_op_cnt] = {
+    "push_back", "push_front", "pop_back", "pop_front", "insert", "erase",
+    "erase_range", "clear", "read", "write", "iterate", "copy"
+  };
+
+  trace_writer::trace_writer(const char *path)
+  {
+    file = std::fopen(path, "wb");
+    if (file == nullptr)
+      return;
+
+    uint32_t value_size = sizeof(value_type);
+    if (std::fwrite(magic, sizeof(magic), 1, file) != 1 || std::fwrite(&value_size, sizeof(value_size), 1, file) != 1)
+    {
+      std::fclose(file);
+      file = nullptr;
+    }
+  }
+  trace_writer::~trace_writer()
+  {
+    if (file != nullptr)
+      std::fclose(file);
+  }
+  bool trace_writer::ok() const
+  {
+    return file != nullptr;
+  }
+  void trace_writer::write(trace_op op, uint64_t pos, uint64_t count, value_type val)
+  {
+    if (file == nullptr)
+      return;
+
+    disk_record rec;
+    std::memset(&rec, 0, sizeof(rec));
+    rec.pos = pos;
+    rec.count = count;
+    rec.val = val;
+    rec.op = op;
+    // a short write (a full disk) would leave a truncated trace; stop and let ok() report it
+    if (std::fwrite(&rec, sizeof(rec), 1, file) != 1)
+    {
+      std::fclose(file);
+      file = nullptr;
+    }
+  }
+  bool trace_writer::flush()
+  {
+    if (file != nullptr && std::fflush(file) != 0)
+    {
+      std::fclose(file);
+      file = nullptr;
+    }
+    return ok();
+  }
+
+  trace_reader::trace_reader(const char *path)
+  {
+    file = std::fopen(path, "rb");
+    if (file == nullptr)
+      return;
+
+    char head[sizeof(magic)];
+    uint32_t value_size = 0;
+    if (std::fread(head, sizeof(head), 1, file) != 1 || std::memcmp(head, magic, sizeof(magic)) != 0 ||
+        std::fread(&value_size, sizeof(value_size), 1, file) != 1 || value_size != sizeof(value_type))
+    {
+      std::fclose(file);
+      file = nullptr;
+    }
+  }
+  trace_reader::~trace_reader()
+  {
+    if (file != nullptr)
+      std::fclose(file);
+  }
+  bool trace_reader::ok() const
+  {
+    return file != nullptr;
+  }
+  bool trace_reader::next(trace_record &rec)
+  {
+    disk_record raw;
+    if (file == nullptr || std::fread(&raw, sizeof(raw), 1, file) != 1 || raw.op >= trace_op_cnt)
+      return false;
+
+    rec.op = static_cast<trace_op>(raw.op);
+    rec.pos = raw.pos;
+    rec.count = raw.count;
+    rec.val = raw.val;
+    return true;
+  }
+
+  void generate_trace(trace_writer &out, uint64_t seed, size_type count)
+  {
+    // relative weight of each trace_op, roughly the mix of check_vector_
+    const int weights[trace_op_cnt] = {4, 3, 2, 3, 10, 6, 3, 1, 6, 3, 2, 2};
+    std::mt19937_64 mt(seed);
+    std::discrete_distribution<int> pick(weights, weights + trace_op_cnt);
+    std::uniform_int_distribution<int> value(0, 255);
+    std::uniform_int_distribution<size_type> insert_count(0, 20);
+
+    size_type size = 0;
+    for (size_type i = 0; i < count; i++)
+    {
+      trace_op op = static_cast<trace_op>(pick(mt));
+      bool needs_element = op == trace_pop_back || op == trace_pop_front || op == trace_erase ||
+                           op == trace_read || op == trace_write;
+      if (needs_element && size == 0)
+        op = trace_push_back;
+
+      value_type val = static_cast<value_type>(value(mt));
+      switch (op)
+      {
+        case trace_push_back:
+        case trace_push_front:
+          out.write(op, 0, 0, val);
+          size++;
+          break;
+        case trace_pop_back:
+        case trace_pop_front:
+          out.write(op);
+          size--;
+          break;
+        case trace_insert:
+        {
+          size_type n = insert_count(mt);
+          out.write(op, mt() % (size + 1), n, val);
+          size += n;
+          break;
+        }
+        case trace_erase:
+          out.write(op, mt() % size);
+          size--;
+          break;
+        case trace_erase_range:
+        {
+          size_type pos = mt() % (size + 1);
+          size_type n = mt() % (size - pos + 1);
+          out.write(op, pos, n);
+          size -= n;
+          break;
+        }
+        case trace_clear:
+          out.write(op);
+          size = 0;
+          break;
+        case trace_read:
+          out.write(op, mt() % size);
+          break;
+        case trace_write:
+          out.write(op, mt() % size, 0, val);
+          break;
+        default:
+          out.write(op);
+          break;
+      }
+    }
+  }
+}  // namespace I2P2